@@ -70,6 +70,26 @@ namespace Api
 {
 namespace MS = MakeASound;
 
+// What the UI and MIDI threads change on the audio thread, one message per change.
+// A note on carries both its fields, so the audio thread never sees the new state
+// with the old gain.
+struct SetPlaying
+{
+    bool playing {};
+};
+
+struct SetGain
+{
+    float gain {};
+};
+
+struct NoteOn
+{
+    float gain {};
+};
+
+using ParameterChanges = MS::ParameterQueue<64, SetPlaying, SetGain, NoteOn>;
+
 class DemoApi
 {
 public:
@@ -109,16 +129,26 @@ public:
     UIState getUi() { return makeUi(); }
     AudioControls getAudio() const { return makeControls(); }
 
+    // Both land at the next block; the UI is shown the new value now, unless the
+    // queue was full and refused it.
     void setPlaying(const bool& value)
     {
-        playing.store(value);
-        audio.publish(makeControls());
+        if (!changes.post(SetPlaying {value}))
+            return;
+
+        auto controls = makeControls();
+        controls.playing = value;
+        audio.publish(controls);
     }
 
     void setGain(const double& value)
     {
-        gainValue.store(static_cast<float>(value));
-        audio.publish(makeControls());
+        if (!changes.post(SetGain {static_cast<float>(value)}))
+            return;
+
+        auto controls = makeControls();
+        controls.gain = value;
+        audio.publish(controls);
     }
 
     void setSampleRate(const int& value)
@@ -225,7 +255,13 @@ public:
         ui.publish(makeUi());
     }
 
-    void pollMeter() { meter.publish(makeMeter()); }
+    // Only the latest level matters, so the outbox coalesces a tick's worth of
+    // blocks down to one.
+    void pollMeter()
+    {
+        meterOutbox.drain([this](float peak) { inputLevel = peak; });
+        meter.publish(makeMeter());
+    }
 
     Miro::Event<UIState> ui;
     Miro::Event<AudioControls> audio;
@@ -267,7 +303,17 @@ private:
             for (auto sample: channel)
                 peak = std::max(peak, std::abs(sample));
 
-        inputLevelValue.store(peak, std::memory_order_relaxed);
+        meterOutbox.post(peak, inputLevelKey);
+
+        changes.applyPending(MS::MIDI::overloaded {
+            [&](const SetPlaying& m) { playing.store(m.playing); },
+            [&](const SetGain& m) { gainValue.store(m.gain); },
+            [&](const NoteOn& m)
+            {
+                playing.store(true);
+                gainValue.store(m.gain);
+            },
+        });
 
         auto on = playing.load(std::memory_order_relaxed);
         auto g = gainValue.load(std::memory_order_relaxed);
@@ -347,18 +393,11 @@ private:
             auto data2 = msg.bytes[2];
 
             if (status == 0x90 && data2 > 0)
-            {
-                playing.store(true);
-                gainValue.store(static_cast<float>(data2) / 127.0f);
-            }
+                changes.post(NoteOn {static_cast<float>(data2) / 127.0f});
             else if (status == 0x80 || (status == 0x90 && data2 == 0))
-            {
-                playing.store(false);
-            }
+                changes.post(SetPlaying {false});
             else if (status == 0xB0 && data1 == 7)
-            {
-                gainValue.store(static_cast<float>(data2) / 127.0f);
-            }
+                changes.post(SetGain {static_cast<float>(data2) / 127.0f});
         }
 
         eacp::Threads::callAsync(
@@ -376,7 +415,7 @@ private:
     }
 
     MeterState makeMeter() const
-    { return {.inputLevel = static_cast<double>(inputLevelValue.load())}; }
+    { return {.inputLevel = static_cast<double>(inputLevel)}; }
 
     UIState makeUi()
     {
@@ -412,9 +451,15 @@ private:
         return state;
     }
 
+    // Written on the audio thread only; atomic so the UI can read them for display.
     std::atomic<bool> playing {false};
     std::atomic<float> gainValue {0.1f};
-    std::atomic<float> inputLevelValue {0.0f};
+    ParameterChanges changes;
+
+    static constexpr int inputLevelKey = 0;
+    MS::Outbox<float, 256> meterOutbox;
+    float inputLevel = 0.0f; // UI thread
+
     MS::DeviceManager manager;
     MS::MidiManager midiManager;
     MS::UIDeviceManager uiDevices {manager};
@@ -3,14 +3,13 @@
 #include "Synth.h"
 
 #include <MakeASound/MakeASound.h>
-#include <eacp/Core/Core.h>
 
-#include <functional>
 #include <utility>
 
 struct AudioProcessor
 {
-    using MidiAppliedCallback = std::function<void(const MIDI::Event&)>;
+    // What the audio thread applied, for the UI's MIDI monitor.
+    using MidiOutbox = MS::Outbox<MIDI::Event, 256>;
 
     AudioProcessor()
     {
@@ -23,9 +22,11 @@ struct AudioProcessor
     const Synth& getSynth() const { return synth; }
     const MS::StreamConfig& getStreamConfig() const { return config; }
 
-    void setMidiAppliedCallback(MidiAppliedCallback cb)
+    // UI thread, from a timer.
+    template <typename Fn>
+    int drainAppliedMidi(Fn&& deliver)
     {
-        midiAppliedCb = std::move(cb);
+        return midiOutbox.drain(std::forward<Fn>(deliver));
     }
 
     void applySampleRate(int rate)
@@ -70,7 +71,7 @@ struct AudioProcessor
         else
         {
             midi.closeInput(portId);
-            synth.releaseAllNotes();
+            synth.requestAllNotesOff();
         }
     }
 
@@ -82,26 +83,38 @@ struct AudioProcessor
             midiSync.reset();
         }
 
-        midiSync.drainForBlock(midi, info.numSamples, info.sampleRate);
+        synth.applyPendingChanges();
+        midiSync.drainForBlock(
+            midi, info.numSamples, info.sampleRate, info.streamTime);
 
-        auto cursor = 0;
-
-        for (auto& evt: midiSync.events())
-        {
-            synth.render(info, cursor, evt.event.sampleOffset);
-            applyMidiOnAudioThread(evt.event);
-            cursor = evt.event.sampleOffset;
-        }
-
-        synth.render(info, cursor, info.numSamples);
+        MS::processBlockWithMidi(
+            midiSync,
+            info.numSamples,
+            1,
+            [&](int start, int end) { synth.render(info, start, end); },
+            [&](const MIDI::Event& event) { applyMidiOnAudioThread(event); });
     }
 
     void applyMidiOnAudioThread(const MIDI::Event& midiEvent)
     {
         synth.applyMidiEvent(midiEvent);
+        midiOutbox.post(midiEvent, monitorKey(midiEvent));
+    }
+
+    // Continuous controls are shown at their latest value per drain, not every step
+    // of a sweep; notes and everything else are all shown.
+    static int monitorKey(const MIDI::Event& event)
+    {
+        if (auto cc = event.asControlChange())
+            return event.getChannel() * 128 + cc->controller;
+
+        if (event.isPitchBend())
+            return 16 * 128 + event.getChannel();
+
+        if (event.isChannelAftertouch())
+            return 17 * 128 + event.getChannel();
 
-        if (midiAppliedCb)
-            eacp::Threads::callAsync([midiEvent, cb = midiAppliedCb] { cb(midiEvent); });
+        return MidiOutbox::noKey;
     }
 
     Synth synth;
@@ -109,5 +122,5 @@ struct AudioProcessor
     MS::MidiManager midi;
     MS::MidiBlockSync midiSync;
     MS::StreamConfig config;
-    MidiAppliedCallback midiAppliedCb;
+    MidiOutbox midiOutbox;
 };
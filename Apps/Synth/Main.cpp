@@ -21,6 +21,7 @@ struct SynthApp
     WebViewBridge transport {webView};
     Window window;
     Threads::Timer midiPollTimer {[this] { api.pollMidiPorts(); }, 2};
+    Threads::Timer audioMessageTimer {[this] { api.drainAudioMessages(); }, 20};
 };
 
 int main()
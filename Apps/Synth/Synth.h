@@ -17,6 +17,19 @@ struct AudioControls
     double velocity {};
 };
 
+// Changes the UI posts to the audio thread. A message per change rather than an
+// atomic per field, so they land whole, in order, and never mid-block.
+struct SetGain
+{
+    float gain {};
+};
+
+struct AllNotesOff
+{
+};
+
+using ParameterChanges = MS::ParameterQueue<64, SetGain, AllNotesOff>;
+
 struct Synth
 {
     static constexpr float twoPi = 2.0f * std::numbers::pi_v<float>;
@@ -85,6 +98,20 @@ struct Synth
         }
     }
 
+    // Audio thread, at the start of each block.
+    void applyPendingChanges()
+    {
+        changes.applyPending(MIDI::overloaded {
+            [&](const SetGain& m) { gain.store(m.gain); },
+            [&](const AllNotesOff&) { releaseAllNotes(); },
+        });
+    }
+
+    // Any thread but the audio thread. False when the audio thread has fallen a
+    // whole queue behind and the change was dropped.
+    bool setGain(float gainToUse) { return changes.post(SetGain {gainToUse}); }
+    bool requestAllNotesOff() { return changes.post(AllNotesOff {}); }
+
     // Called on the audio thread.
     void applyMidiEvent(const MIDI::Event& event)
     {
@@ -132,8 +159,6 @@ struct Synth
         velocity.store(0.0f);
     }
 
-    void setGain(float gainToUse) { gain.store(gainToUse); }
-
     AudioControls makeControls() const
     {
         auto noteValue = note.load();
@@ -150,10 +175,12 @@ struct Synth
         return controls;
     }
 
+    // Written on the audio thread only; atomic so the UI can read them for display.
     std::atomic<int> note {-1};
     std::atomic<float> velocity {0.0f};
     std::atomic<float> gain {0.5f};
 
     SineVoice voice;
     std::vector<int> heldNotes;
+    ParameterChanges changes;
 };
@@ -39,12 +39,6 @@ namespace Api
 class SynthApi
 {
 public:
-    SynthApi()
-    {
-        processor.setMidiAppliedCallback(
-            [this](const MIDI::Event& event) { onMidiApplied(event); });
-    }
-
     void reflect(Miro::ApiReflector& r)
     {
         using T = SynthApi;
@@ -67,7 +61,11 @@ public:
     void setGain(const double& value)
     {
         processor.getSynth().setGain(static_cast<float>(value));
-        audio.publish(processor.getSynth().makeControls());
+
+        // The change lands at the next block; show it now rather than the old value.
+        auto controls = processor.getSynth().makeControls();
+        controls.gain = value;
+        audio.publish(controls);
     }
 
     void setSampleRate(const int& value)
@@ -94,7 +92,19 @@ public:
         ui.publish(makeUi());
     }
 
-    void allNotesOff() { processor.getSynth().releaseAllNotes(); }
+    void allNotesOff() { processor.getSynth().requestAllNotesOff(); }
+
+    // Batches what the audio thread applied since the last tick into the MIDI log,
+    // and refreshes the controls once if anything changed.
+    void drainAudioMessages()
+    {
+        auto applied = processor.drainAppliedMidi(
+            [this](const MIDI::Event& event)
+            { midi.publish({MIDI::toString(event)}); });
+
+        if (applied > 0)
+            audio.publish(processor.getSynth().makeControls());
+    }
 
     void pollMidiPorts()
     {
@@ -112,12 +122,6 @@ public:
     Miro::Event<MidiLogEntry> midi;
 
 private:
-    void onMidiApplied(const MIDI::Event& event)
-    {
-        midi.publish({MIDI::toString(event)});
-        audio.publish(processor.getSynth().makeControls());
-    }
-
     UIState makeUi()
     {
         auto& config = processor.getStreamConfig();
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <limits>
+
+namespace Benchmark
+{
+
+// Written through a volatile so the optimiser can't drop work whose result is never
+// read. Portable, unlike an empty asm statement, which MSVC doesn't have.
+inline volatile float sink = 0.0f;
+
+inline void consume(float value)
+{
+    sink = value;
+}
+
+// Best of `repeats` runs of `iterations` calls, in nanoseconds per call. The minimum
+// rather than the mean: anything slower than it is the machine, not the code.
+template <class Fn>
+double nsPerCall(Fn&& body, int iterations = 2000, int repeats = 7)
+{
+    using Clock = std::chrono::steady_clock;
+
+    for (auto i = 0; i < iterations / 10 + 1; ++i)
+        body();
+
+    auto best = std::numeric_limits<double>::max();
+
+    for (auto run = 0; run < repeats; ++run)
+    {
+        auto start = Clock::now();
+
+        for (auto i = 0; i < iterations; ++i)
+            body();
+
+        auto elapsed =
+            std::chrono::duration<double, std::nano>(Clock::now() - start);
+        best = std::min(best, elapsed.count() / iterations);
+    }
+
+    return best;
+}
+
+inline void printHeader(const char* title)
+{
+    std::printf("\n%s\n", title);
+}
+
+inline void printRow(const char* label, double baselineNs, double candidateNs)
+{
+    std::printf("  %-34s %10.1f ns %10.1f ns %7.2fx\n",
+                label,
+                baselineNs,
+                candidateNs,
+                baselineNs / candidateNs);
+}
+
+} // namespace Benchmark
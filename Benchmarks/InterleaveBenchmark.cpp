@@ -0,0 +1,87 @@
+// Scalar frame-by-channel loops against the vector kernels, both directions, at the
+// shapes the MiniAudio callback actually sees: whole-device transfers on common
+// interface widths, and a stereo pair picked out of a wide interface.
+
+#include "Benchmark.h"
+
+#include <MakeASound/Audio/Interleave.h>
+
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+struct Shape
+{
+    const char* label;
+    int deviceChannels;
+    int firstChannel;
+    int count;
+    int frames;
+};
+
+constexpr Shape shapes[] = {
+    {"mono, 64 frames", 1, 0, 1, 64},
+    {"stereo, 64 frames", 2, 0, 2, 64},
+    {"stereo, 512 frames", 2, 0, 2, 512},
+    {"8ch, 64 frames", 8, 0, 8, 64},
+    {"16ch, 64 frames", 16, 0, 16, 64},
+    {"32ch, 64 frames", 32, 0, 32, 64},
+    {"32ch, 512 frames", 32, 0, 32, 512},
+    {"18ch (runtime stride), 64 frames", 18, 0, 18, 64},
+    {"2 of 32ch, 64 frames", 32, 4, 2, 64},
+};
+
+using Kernel = void (*)(const float*, float*, int, int, int, int) noexcept;
+
+double measure(Kernel kernel,
+               const std::vector<float>& src,
+               std::vector<float>& dst,
+               const Shape& shape)
+{
+    return Benchmark::nsPerCall(
+        [&]
+        {
+            kernel(src.data(),
+                   dst.data(),
+                   shape.deviceChannels,
+                   shape.firstChannel,
+                   shape.count,
+                   shape.frames);
+            Benchmark::consume(dst[0]);
+        });
+}
+} // namespace
+
+int main()
+{
+    std::printf("%-36s %13s %13s %8s", "", "scalar", "vector", "speedup");
+
+    Benchmark::printHeader("deinterleave (device -> planar)");
+
+    for (const auto& shape: shapes)
+    {
+        auto native = std::vector<float>(shape.deviceChannels * shape.frames, 0.5f);
+        auto planar = std::vector<float>(shape.count * shape.frames);
+
+        Benchmark::printRow(
+            shape.label,
+            measure(MakeASound::deinterleaveSliceScalar, native, planar, shape),
+            measure(MakeASound::deinterleaveSlice, native, planar, shape));
+    }
+
+    Benchmark::printHeader("interleave (planar -> device)");
+
+    for (const auto& shape: shapes)
+    {
+        auto planar = std::vector<float>(shape.count * shape.frames, 0.5f);
+        auto native = std::vector<float>(shape.deviceChannels * shape.frames);
+
+        Benchmark::printRow(
+            shape.label,
+            measure(MakeASound::interleaveSliceScalar, planar, native, shape),
+            measure(MakeASound::interleaveSlice, planar, native, shape));
+    }
+
+    return 0;
+}
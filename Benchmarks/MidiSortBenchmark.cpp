@@ -0,0 +1,93 @@
+// Ordering one block's MIDI when several ports were drained one after another: each
+// port's events sorted among themselves, the ports interleaved in time. The baseline
+// is the insertion sort sortByOffset() uses, the candidate the run merge through a
+// preallocated scratch that MidiBlockSync now uses. One port is already sorted and
+// both are linear; from there insertion sort grows with the square of the events.
+
+#include "Benchmark.h"
+
+#include <MakeASound/MIDI/MIDI.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace
+{
+namespace MIDI = MakeASound::MIDI;
+
+constexpr auto blockSize = 512;
+
+// `total` events spread over `ports` ports, each port's offsets ascending and
+// covering the whole block, appended a port at a time as drainMessages does.
+MIDI::Buffer makePorts(int ports, int total)
+{
+    auto rng = std::mt19937 {42};
+    auto events = MIDI::Buffer {};
+    events.reserve(total);
+
+    for (auto port = 0; port < ports; ++port)
+    {
+        auto count = total / ports + (port < total % ports ? 1 : 0);
+        auto offsets = std::vector<int>(static_cast<std::size_t>(count));
+
+        for (auto& offset: offsets)
+            offset = static_cast<int>(rng() % blockSize);
+
+        std::sort(offsets.begin(), offsets.end());
+
+        for (auto offset: offsets)
+            events.add(MIDI::Event::controlChange(port, 1, 0.5f, offset));
+    }
+
+    return events;
+}
+} // namespace
+
+int main()
+{
+    std::printf("%-36s %13s %13s %8s", "", "insertion", "run merge", "ratio");
+
+    for (auto ports: {1, 2, 4, 8, 16})
+    {
+        char title[64];
+        std::snprintf(title, sizeof(title), "%d ports", ports);
+        Benchmark::printHeader(title);
+
+        for (auto total: {10, 100, 1000, 10000})
+        {
+            auto input = makePorts(ports, total);
+            auto events = input;
+            auto scratch = std::vector<MIDI::Event>(input.size());
+
+            // Fewer calls for the big blocks, where quadratic insertion sort takes
+            // milliseconds a call.
+            auto iterations = std::max(5, 200'000 / total);
+
+            auto insertion = Benchmark::nsPerCall(
+                [&]
+                {
+                    std::copy(input.begin(), input.end(), events.begin());
+                    events.sortByOffset();
+                    Benchmark::consume(static_cast<float>(events[0].sampleOffset));
+                },
+                iterations);
+
+            auto merge = Benchmark::nsPerCall(
+                [&]
+                {
+                    std::copy(input.begin(), input.end(), events.begin());
+                    events.sortByOffset(scratch);
+                    Benchmark::consume(static_cast<float>(events[0].sampleOffset));
+                },
+                iterations);
+
+            char label[64];
+            std::snprintf(label, sizeof(label), "%d events", total);
+            Benchmark::printRow(label, insertion, merge);
+        }
+    }
+
+    return 0;
+}
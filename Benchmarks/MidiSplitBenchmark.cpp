@@ -0,0 +1,131 @@
+// What processBlockWithMidi costs on dense controller streams - a mod wheel or an
+// automation lane sending a CC every few samples - against rendering the same block
+// in one piece and applying every event up front. The render is a smoothed-gain
+// filter with a per-slice setup, so the overhead measured is the real one a synth
+// pays per cut, and the minimum slice length is what buys it back.
+
+#include "Benchmark.h"
+
+#include <MakeASound/MIDI/MidiBlockSync.h>
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+namespace MIDI = MakeASound::MIDI;
+
+constexpr auto blockSize = 512;
+constexpr auto channels = 2;
+
+struct Voice
+{
+    // Per slice: what a real render does once before its loop.
+    void setCutoff(float controller)
+    {
+        coefficient = 1.0f - std::exp(-0.05f - controller);
+    }
+
+    // Reads a fixed input rather than filtering in place, which would decay the
+    // block towards denormals over the run and time those instead. Both channels in
+    // one loop: channel by channel, short slices would let the CPU overlap the two
+    // filters' dependency chains, and splitting would come out faster than not.
+    void render(const float* input, float* const* output, int start, int end)
+    {
+        // Locals, or the stores through output could alias them and force a reload
+        // every sample.
+        auto k = coefficient;
+        auto left = states[0];
+        auto right = states[1];
+
+        for (auto i = start; i < end; ++i)
+        {
+            left += k * (input[i] - left);
+            right += k * (-input[i] - right);
+            output[0][i] = left;
+            output[1][i] = right;
+        }
+
+        states[0] = left;
+        states[1] = right;
+    }
+
+    float coefficient = 0.5f;
+    float states[channels] {};
+};
+
+MIDI::Buffer makeControllerStream(int eventsPerBlock)
+{
+    auto events = MIDI::Buffer {};
+    events.reserve(eventsPerBlock);
+
+    for (auto i = 0; i < eventsPerBlock; ++i)
+    {
+        auto value = static_cast<float>(i) / static_cast<float>(eventsPerBlock);
+        events.add(
+            MIDI::Event::controlChange(0, 1, value, i * blockSize / eventsPerBlock));
+    }
+
+    return events;
+}
+} // namespace
+
+int main()
+{
+    auto input = std::vector<float>(blockSize);
+
+    for (auto i = 0; i < blockSize; ++i)
+        input[static_cast<std::size_t>(i)] = (i % 64 < 32) ? 0.5f : -0.5f;
+
+    auto samples = std::vector<float>(channels * blockSize);
+    float* output[channels] = {samples.data(), samples.data() + blockSize};
+
+    std::printf("%-36s %13s %13s %8s", "", "unsplit", "split", "ratio");
+
+    for (auto density: {8, 64, 512})
+    {
+        auto events = makeControllerStream(density);
+
+        char title[64];
+        std::snprintf(
+            title, sizeof(title), "%d CCs per %d-sample block", density, blockSize);
+        Benchmark::printHeader(title);
+
+        auto voice = Voice {};
+
+        auto unsplit = Benchmark::nsPerCall(
+            [&]
+            {
+                for (const auto& event: events)
+                    voice.setCutoff(event.asControlChange()->value);
+
+                voice.render(input.data(), output, 0, blockSize);
+                Benchmark::consume(samples[0]);
+            });
+
+        for (auto minSubBlock: {1, 16, 64})
+        {
+            auto split = Benchmark::nsPerCall(
+                [&]
+                {
+                    MakeASound::processBlockWithMidi(
+                        events,
+                        blockSize,
+                        minSubBlock,
+                        [&](int start, int end)
+                        { voice.render(input.data(), output, start, end); },
+                        [&](const MIDI::Event& event)
+                        { voice.setCutoff(event.asControlChange()->value); });
+
+                    Benchmark::consume(samples[0]);
+                });
+
+            char label[64];
+            std::snprintf(label, sizeof(label), "min sub-block %d", minSubBlock);
+            Benchmark::printRow(label, unsplit, split);
+        }
+    }
+
+    return 0;
+}
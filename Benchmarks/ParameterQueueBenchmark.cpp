@@ -0,0 +1,173 @@
+// What the audio thread pays per block to pick up UI changes: a ParameterQueue it
+// drains at the block start, against the separate atomics it used to load - gain,
+// note and velocity - while an automation thread writes them flat out, as a UI
+// dragging three sliders at once would. The queue costs more per change, which is
+// the price of changes arriving whole and in order; the rows show how much.
+
+#include "Benchmark.h"
+
+#include <MakeASound/MIDI/MIDI.h>
+#include <MakeASound/Realtime/ParameterQueue.h>
+
+#include <atomic>
+#include <cstdio>
+#include <thread>
+
+namespace
+{
+namespace MIDI = MakeASound::MIDI;
+
+struct SetGain
+{
+    float gain = 0.0f;
+};
+
+struct NoteOn
+{
+    int note = 0;
+    float velocity = 0.0f;
+};
+
+using Changes = MakeASound::ParameterQueue<1024, SetGain, NoteOn>;
+
+struct Atomics
+{
+    std::atomic<float> gain {0.0f};
+    std::atomic<int> note {0};
+    std::atomic<float> velocity {0.0f};
+};
+
+// The audio thread's copy, which both versions end up reading their block from.
+struct State
+{
+    float gain = 0.0f;
+    int note = 0;
+    float velocity = 0.0f;
+
+    float sum() const { return gain + static_cast<float>(note) + velocity; }
+};
+
+void postChanges(Changes& changes, int count)
+{
+    for (auto i = 0; i < count; ++i)
+    {
+        changes.post(SetGain {static_cast<float>(i)});
+        changes.post(NoteOn {i & 127, 0.5f});
+    }
+}
+
+void storeChanges(Atomics& atomics, int count)
+{
+    for (auto i = 0; i < count; ++i)
+    {
+        atomics.gain.store(static_cast<float>(i));
+        atomics.note.store(i & 127);
+        atomics.velocity.store(0.5f);
+    }
+}
+
+int applyChanges(Changes& changes, State& state)
+{
+    return changes.applyPending(MIDI::overloaded {
+        [&](const SetGain& m) { state.gain = m.gain; },
+        [&](const NoteOn& m)
+        {
+            state.note = m.note;
+            state.velocity = m.velocity;
+        },
+    });
+}
+
+void loadAtomics(const Atomics& atomics, State& state)
+{
+    state.gain = atomics.gain.load();
+    state.note = atomics.note.load();
+    state.velocity = atomics.velocity.load();
+}
+
+// Both sides on this thread: the changes a UI makes in one block, and the audio
+// thread picking them up.
+void uncontended()
+{
+    Benchmark::printHeader("changes per block, one thread");
+
+    for (auto perBlock: {1, 16, 256})
+    {
+        auto atomics = Atomics {};
+        auto changes = Changes {};
+        auto state = State {};
+
+        auto viaAtomics = Benchmark::nsPerCall(
+            [&]
+            {
+                storeChanges(atomics, perBlock);
+                loadAtomics(atomics, state);
+                Benchmark::consume(state.sum());
+            });
+
+        auto viaQueue = Benchmark::nsPerCall(
+            [&]
+            {
+                postChanges(changes, perBlock);
+                applyChanges(changes, state);
+                Benchmark::consume(state.sum());
+            });
+
+        char label[64];
+        std::snprintf(label, sizeof(label), "%d changes", perBlock);
+        Benchmark::printRow(label, viaAtomics, viaQueue);
+    }
+}
+
+// An automation thread writing as fast as it can while this thread, the audio
+// thread, times its block-start pickup. Only the audio side is timed: it's the one
+// with a deadline.
+void contended()
+{
+    Benchmark::printHeader("audio-thread pickup under flat-out automation");
+
+    auto atomics = Atomics {};
+    auto changes = Changes {};
+    auto state = State {};
+    auto running = std::atomic<bool> {true};
+
+    auto automation = std::thread(
+        [&]
+        {
+            while (running.load(std::memory_order_relaxed))
+            {
+                storeChanges(atomics, 16);
+                postChanges(changes, 16);
+            }
+        });
+
+    auto viaAtomics = Benchmark::nsPerCall(
+        [&]
+        {
+            loadAtomics(atomics, state);
+            Benchmark::consume(state.sum());
+        });
+
+    auto viaQueue = Benchmark::nsPerCall(
+        [&]
+        {
+            applyChanges(changes, state);
+            Benchmark::consume(state.sum());
+        });
+
+    running.store(false, std::memory_order_relaxed);
+    automation.join();
+
+    Benchmark::printRow("one block start", viaAtomics, viaQueue);
+}
+} // namespace
+
+int main()
+{
+    std::printf("%-36s %13s %13s %8s", "", "atomics", "queue", "ratio");
+
+    uncontended();
+    contended();
+
+    return 0;
+}
@@ -0,0 +1,138 @@
+// What each kind of setConfig costs a running stream, on the default output device.
+// Two numbers per change: how long the call takes, and the longest gap between audio
+// callbacks around it — the glitch a listener hears. "Nothing" is the same
+// measurement with no change at all, the device's own jitter to compare against. A
+// callback swap and a channel-slice change go to the open device at its next block,
+// so their gap should be that; a block-size or sample-rate change closes the device
+// and opens another, and the gap is the whole teardown and bring-up. Needs an output
+// device; on a machine without one it says so and measures nothing.
+
+#include "Benchmark.h"
+
+#include <MakeASound/MakeASound.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <thread>
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+using MakeASound::StreamConfig;
+
+// Written by the audio thread only, read once it has settled.
+std::atomic<std::int64_t> lastCallbackNs {0};
+std::atomic<std::int64_t> longestGapNs {0};
+
+std::int64_t nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               Clock::now().time_since_epoch())
+        .count();
+}
+
+MakeASound::Callback makeCallback()
+{
+    return [](MakeASound::AudioCallbackInfo&)
+    {
+        auto now = nowNs();
+        auto last = lastCallbackNs.exchange(now, std::memory_order_relaxed);
+
+        if (last != 0 && now - last > longestGapNs.load(std::memory_order_relaxed))
+            longestGapNs.store(now - last, std::memory_order_relaxed);
+    };
+}
+
+// Lets the stream settle, applies `change`, and reports the call and the gap.
+void measure(const char* label, const std::function<void()>& change)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    longestGapNs = 0;
+
+    auto start = Clock::now();
+    change();
+    auto call = std::chrono::duration<double, std::milli>(Clock::now() - start);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+    std::printf("  %-34s %10.2f ms %10.2f ms\n",
+                label,
+                call.count(),
+                static_cast<double>(longestGapNs.load()) / 1e6);
+}
+
+// A rate the device has that the stream isn't running at, or 0.
+int otherSampleRate(const StreamConfig& config)
+{
+    for (auto rate: config.output->device.sampleRates)
+        if (rate != config.sampleRate)
+            return rate;
+
+    return 0;
+}
+} // namespace
+
+int main()
+{
+    auto manager = MakeASound::DeviceManager {};
+    auto config = manager.getDefaultConfig();
+
+    if (!config.output.has_value())
+    {
+        std::printf("No output device; nothing to measure.\n");
+        return 0;
+    }
+
+    if (manager.start(config, makeCallback()) != MakeASound::Error::NoError)
+    {
+        std::printf("The default output device won't open; nothing to measure.\n");
+        return 0;
+    }
+
+    std::printf("%-36s %13s %13s", "", "call", "longest gap");
+    Benchmark::printHeader("live: the device stays open");
+
+    measure("nothing", [] {});
+    measure("same config, new callback",
+            [&] { manager.start(config, makeCallback()); });
+
+    if (config.output->nChannels >= 2)
+    {
+        measure("output channel count",
+                [&]
+                {
+                    config.output->nChannels = 1;
+                    manager.setConfig(config);
+                });
+
+        measure("output first channel",
+                [&]
+                {
+                    config.output->firstChannel = 1;
+                    manager.setConfig(config);
+                });
+    }
+
+    Benchmark::printHeader("re-open: another device");
+
+    measure("block size",
+            [&]
+            {
+                config.maxBlockSize *= 2;
+                manager.setConfig(config);
+            });
+
+    if (auto rate = otherSampleRate(config); rate > 0)
+        measure("sample rate",
+                [&]
+                {
+                    config.sampleRate = rate;
+                    manager.setConfig(config);
+                });
+
+    manager.stop();
+    return 0;
+}
@@ -0,0 +1,109 @@
+// Messages per second through SPSCQueue and PaddedSPSCQueue, one producer thread and
+// one consumer thread both spinning flat out. That is the worst case for the plain
+// queue - every push reloads the index the consumer just wrote, on a line it shares
+// with the producer's own - and the case the padded one is built for. Same element,
+// same capacity (the plain queue's is one less, so it has the same ring size).
+
+#include "Benchmark.h"
+
+#include <MakeASound/Realtime/PaddedSPSCQueue.h>
+#include <MakeASound/Realtime/SPSCQueue.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <thread>
+
+namespace
+{
+// A typical parameter change or MIDI event: small, trivially copyable.
+struct Message
+{
+    std::uint32_t id = 0;
+    float value = 0.0f;
+};
+
+constexpr auto messagesPerRun = 10'000'000;
+constexpr auto repeats = 5;
+
+// Best of `repeats` runs, in messages per second. The queue is on the heap: the
+// large capacities don't belong on the stack.
+template <class Queue>
+double messagesPerSecond()
+{
+    using Clock = std::chrono::steady_clock;
+
+    auto best = 0.0;
+
+    for (auto run = 0; run < repeats; ++run)
+    {
+        auto queue = std::make_unique<Queue>();
+        auto checksum = 0.0f;
+
+        auto start = Clock::now();
+
+        auto consumer = std::thread(
+            [&]
+            {
+                auto item = Message {};
+
+                for (auto received = 0; received < messagesPerRun;)
+                {
+                    if (queue->pop(item))
+                    {
+                        checksum += item.value;
+                        ++received;
+                    }
+                }
+            });
+
+        for (auto i = 0; i < messagesPerRun; ++i)
+        {
+            auto message = Message {static_cast<std::uint32_t>(i), 1.0f};
+
+            while (!queue->push(message))
+                ; // full - spin until the consumer frees a slot
+        }
+
+        consumer.join();
+
+        auto elapsed = std::chrono::duration<double>(Clock::now() - start);
+        best = std::max(best, messagesPerRun / elapsed.count());
+        Benchmark::consume(checksum);
+    }
+
+    return best;
+}
+
+template <std::size_t RingSize>
+void compare()
+{
+    auto plain = messagesPerSecond<MakeASound::SPSCQueue<Message, RingSize - 1>>();
+    auto padded =
+        messagesPerSecond<MakeASound::PaddedSPSCQueue<Message, RingSize>>();
+
+    char label[64];
+    std::snprintf(label, sizeof(label), "ring of %zu", RingSize);
+
+    std::printf("  %-34s %9.1f M/s %9.1f M/s %7.2fx\n",
+                label,
+                plain / 1e6,
+                padded / 1e6,
+                padded / plain);
+}
+} // namespace
+
+int main()
+{
+    std::printf("%-36s %13s %13s %8s", "", "SPSCQueue", "Padded", "ratio");
+    Benchmark::printHeader("1 producer, 1 consumer, 8-byte messages");
+
+    compare<16>();
+    compare<256>();
+    compare<4096>();
+    compare<65536>();
+
+    return 0;
+}
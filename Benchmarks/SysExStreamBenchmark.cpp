@@ -0,0 +1,141 @@
+// What a SysEx message costs on the way in. The baseline is the MidiMessage callback
+// path: the bytes copied into a freshly allocated vector, which on a quiet
+// single-threaded allocator is about the cost of the copy alone. The candidate is a
+// SysExStream fed in 256-byte chunks, as drivers split long messages, and drained: a
+// scan for status bytes and a copy into the arena, with nothing allocated, so it
+// costs a few times the bare copy and doesn't contend with anyone's allocator. Then
+// the number a sample dump or firmware transfer cares about: megabytes per second
+// from a feeding thread to a draining one, against USB MIDI's one or so.
+
+#include "Benchmark.h"
+
+#include <MakeASound/MIDI/SysExStream.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace
+{
+using MakeASound::SysExStream;
+using Bytes = std::vector<std::uint8_t>;
+
+constexpr auto chunkSize = std::size_t {256};
+
+Bytes makeSysEx(std::size_t size)
+{
+    auto bytes = Bytes(size, 0x55);
+    bytes.front() = 0xF0;
+    bytes.back() = 0xF7;
+    return bytes;
+}
+
+void feedChunked(SysExStream& stream, const Bytes& message)
+{
+    for (auto at = std::size_t {0}; at < message.size(); at += chunkSize)
+    {
+        auto end = std::min(message.size(), at + chunkSize);
+        stream.feed({message.data() + at, end - at});
+    }
+}
+
+void perMessage()
+{
+    Benchmark::printHeader("one message in, one out");
+
+    for (auto size: {16, 256, 4096, 65536})
+    {
+        auto message = makeSysEx(static_cast<std::size_t>(size));
+        auto stream = SysExStream {1 << 20};
+        auto iterations = std::max(50, 2'000'000 / size);
+
+        auto viaVector = Benchmark::nsPerCall(
+            [&]
+            {
+                auto copy = Bytes {};
+                copy.assign(message.begin(), message.end());
+                Benchmark::consume(static_cast<float>(copy[copy.size() / 2]));
+            },
+            iterations);
+
+        auto viaStream = Benchmark::nsPerCall(
+            [&]
+            {
+                feedChunked(stream, message);
+                stream.drain(
+                    [](std::span<const std::uint8_t> bytes)
+                    {
+                        auto middle = bytes[bytes.size() / 2];
+                        Benchmark::consume(static_cast<float>(middle));
+                    });
+            },
+            iterations);
+
+        char label[64];
+        std::snprintf(label, sizeof(label), "%d bytes", size);
+        Benchmark::printRow(label, viaVector, viaStream);
+    }
+}
+
+// 64 MB in 4 KB messages through a 1 MB arena; the feeder waits while the arena is
+// full rather than dropping.
+void acrossThreads()
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr auto messageSize = std::size_t {4096};
+    constexpr auto messageCount = 16 * 1024;
+    constexpr auto inFlight = 200;
+
+    auto message = makeSysEx(messageSize);
+    auto stream = SysExStream {1 << 20};
+    auto delivered = std::atomic<int> {0};
+
+    auto start = Clock::now();
+
+    auto drainer = std::thread(
+        [&]
+        {
+            while (delivered.load(std::memory_order_relaxed) < messageCount)
+            {
+                auto count = stream.drain([](std::span<const std::uint8_t> bytes)
+                                          { Benchmark::consume(bytes[1]); });
+                delivered.fetch_add(count, std::memory_order_release);
+            }
+        });
+
+    for (auto i = 0; i < messageCount; ++i)
+    {
+        while (i - delivered.load(std::memory_order_acquire) >= inFlight)
+            std::this_thread::yield();
+
+        feedChunked(stream, message);
+    }
+
+    drainer.join();
+
+    auto seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    auto megabytes = static_cast<double>(messageSize * messageCount) / (1 << 20);
+
+    Benchmark::printHeader("feeding thread to draining thread");
+    std::printf("  %-34s %10.0f MB/s (%llu dropped)\n",
+                "64 MB in 4 KB messages",
+                megabytes / seconds,
+                static_cast<unsigned long long>(stream.getDropped()));
+}
+} // namespace
+
+int main()
+{
+    std::printf("%-36s %13s %13s %8s", "", "vector", "stream", "ratio");
+
+    perMessage();
+    acrossThreads();
+
+    return 0;
+}
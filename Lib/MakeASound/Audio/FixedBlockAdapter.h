@@ -0,0 +1,145 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace MakeASound
+{
+
+// Re-blocks whatever period sizes a device delivers into blocks of exactly blockSize
+// frames — Pulse, ALSA and JACK all vary theirs, and an FFT wants the same count
+// every time. Input frames queue until a whole block is there; each block's output
+// queues until the device asks for it. The output side is primed with blockSize - 1
+// frames of silence, the least that covers any period sequence, and that is the
+// latency it adds in both directions.
+//
+// Both queues are filled and drained on the audio thread alone, so they need no
+// atomics; they are linear rather than rings so the front of each is one contiguous
+// block the kernels and the host work on in place. Neither ever holds more than two
+// blocks, so everything but prepare() is allocation-free.
+class FixedBlockAdapter
+{
+public:
+    // Not realtime: sizes both queues and primes the output. Frames are interleaved,
+    // inputChannels / outputChannels apart; either may be zero.
+    void prepare(int inputChannelsToUse, int outputChannelsToUse, int blockSizeToUse)
+    {
+        inputChannels = inputChannelsToUse;
+        outputChannels = outputChannelsToUse;
+        blockSize = std::max(1, blockSizeToUse);
+
+        auto capacity = 2 * blockSize;
+
+        inputQueue.assign(static_cast<std::size_t>(inputChannels * capacity), 0.0f);
+        outputQueue.assign(static_cast<std::size_t>(outputChannels * capacity),
+                           0.0f);
+
+        reset();
+    }
+
+    // Drops whatever is queued and re-primes, as at prepare().
+    void reset() noexcept
+    {
+        inputFrames = 0;
+        outputFrames = getLatency();
+
+        std::fill(outputQueue.begin(), outputQueue.end(), 0.0f);
+    }
+
+    int getBlockSize() const noexcept { return blockSize; }
+
+    // Frames between a sample entering process() and its result leaving it.
+    int getLatency() const noexcept { return blockSize - 1; }
+
+    // One device period. input / output are `frames` interleaved frames, either null
+    // when the device has no such side; a null input reads as silence. Calls
+    // block(const float* in, float* out) once per whole block that becomes
+    // available, with exactly getBlockSize() frames — out arrives silent — and fills
+    // output from what earlier blocks produced.
+    template <typename BlockFn>
+    void process(const float* input, float* output, int frames, BlockFn&& block)
+    {
+        // A period longer than a block goes through a block at a time, which is what
+        // keeps each queue within its two blocks however long the period.
+        for (auto offset = 0; offset < frames; offset += blockSize)
+        {
+            auto count = std::min(blockSize, frames - offset);
+
+            pushInput(input != nullptr ? input + offset * inputChannels : nullptr,
+                      count);
+
+            // Before the push fewer than blockSize frames were waiting, so at most
+            // one block is ready now.
+            if (inputFrames >= blockSize)
+            {
+                auto* out = appendOutputBlock();
+                block(static_cast<const float*>(inputQueue.data()), out);
+                popFront(inputQueue, inputFrames, inputChannels, nullptr, blockSize);
+            }
+
+            popFront(outputQueue,
+                     outputFrames,
+                     outputChannels,
+                     output != nullptr ? output + offset * outputChannels : nullptr,
+                     count);
+        }
+    }
+
+private:
+    void pushInput(const float* src, int count) noexcept
+    {
+        auto* dst = inputQueue.data() + inputFrames * inputChannels;
+        auto samples = static_cast<std::size_t>(count * inputChannels);
+
+        if (src != nullptr && samples > 0)
+            std::memcpy(dst, src, samples * sizeof(float));
+        else
+            std::fill(dst, dst + samples, 0.0f);
+
+        inputFrames += count;
+    }
+
+    float* appendOutputBlock() noexcept
+    {
+        auto* dst = outputQueue.data() + outputFrames * outputChannels;
+        std::fill(dst, dst + blockSize * outputChannels, 0.0f);
+        outputFrames += blockSize;
+
+        return dst;
+    }
+
+    // What remains after the front is taken — less than a block — moves down to the
+    // start, so the front stays contiguous.
+    static void popFront(std::vector<float>& queue,
+                         int& frames,
+                         int channels,
+                         float* dst,
+                         int count) noexcept
+    {
+        auto taken = static_cast<std::size_t>(count * channels);
+        auto remaining = static_cast<std::size_t>((frames - count) * channels);
+
+        if (dst != nullptr && taken > 0)
+            std::memcpy(dst, queue.data(), taken * sizeof(float));
+
+        if (remaining > 0)
+            std::memmove(
+                queue.data(), queue.data() + taken, remaining * sizeof(float));
+
+        frames -= count;
+    }
+
+    int inputChannels = 0;
+    int outputChannels = 0;
+    int blockSize = 1;
+
+    std::vector<float> inputQueue;
+    std::vector<float> outputQueue;
+
+    // Per queue, so a side with no channels still keeps time.
+    int inputFrames = 0;
+    int outputFrames = 0;
+};
+
+} // namespace MakeASound
@@ -0,0 +1,435 @@
+#include "Interleave.h"
+
+#include <cstring>
+
+// Whatever the target already guarantees, picked at compile time: SSE2 is the
+// x86-64 baseline and NEON the arm64 one, so every CI slice gets a vector path
+// without a runtime dispatch. AVX is only used when the build opts into it
+// (-mavx2, /arch:AVX2).
+#if defined(__AVX__)
+#include <immintrin.h>
+#define MAKEASOUND_INTERLEAVE_AVX 1
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MAKEASOUND_INTERLEAVE_SSE2 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define MAKEASOUND_INTERLEAVE_NEON 1
+#endif
+
+namespace MakeASound
+{
+namespace
+{
+// Both directions are the same operation: deinterleaving transposes a frames x count
+// matrix into count x frames, interleaving transposes it back. Row r of the source
+// starts at src + r * srcStride, row c of the destination at dst + c * dstStride.
+void transposeScalar(const float* src,
+                     int srcStride,
+                     float* dst,
+                     int dstStride,
+                     int rowBegin,
+                     int rowEnd,
+                     int colBegin,
+                     int colEnd) noexcept
+{
+    for (auto col = colBegin; col < colEnd; ++col)
+        for (auto row = rowBegin; row < rowEnd; ++row)
+            dst[col * dstStride + row] = src[row * srcStride + col];
+}
+
+// One Width x Width tile: Width unaligned loads, an in-register transpose, Width
+// unaligned stores. Specialised per instruction set below.
+template <int Width>
+void transposeTile(const float* src,
+                   int srcStride,
+                   float* dst,
+                   int dstStride) noexcept;
+
+#if MAKEASOUND_INTERLEAVE_SSE2
+constexpr auto kVectorWidth = 4;
+
+template <>
+void transposeTile<4>(const float* src,
+                      int srcStride,
+                      float* dst,
+                      int dstStride) noexcept
+{
+    auto r0 = _mm_loadu_ps(src);
+    auto r1 = _mm_loadu_ps(src + srcStride);
+    auto r2 = _mm_loadu_ps(src + 2 * srcStride);
+    auto r3 = _mm_loadu_ps(src + 3 * srcStride);
+
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+    _mm_storeu_ps(dst, r0);
+    _mm_storeu_ps(dst + dstStride, r1);
+    _mm_storeu_ps(dst + 2 * dstStride, r2);
+    _mm_storeu_ps(dst + 3 * dstStride, r3);
+}
+
+void splitStereo(const float* src, float* left, float* right, int frames) noexcept
+{
+    auto frame = 0;
+
+    for (; frame + 4 <= frames; frame += 4)
+    {
+        auto a = _mm_loadu_ps(src + 2 * frame);
+        auto b = _mm_loadu_ps(src + 2 * frame + 4);
+
+        _mm_storeu_ps(left + frame, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+        _mm_storeu_ps(right + frame, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+
+    for (; frame < frames; ++frame)
+    {
+        left[frame] = src[2 * frame];
+        right[frame] = src[2 * frame + 1];
+    }
+}
+
+void joinStereo(const float* left,
+                const float* right,
+                float* dst,
+                int frames) noexcept
+{
+    auto frame = 0;
+
+    for (; frame + 4 <= frames; frame += 4)
+    {
+        auto l = _mm_loadu_ps(left + frame);
+        auto r = _mm_loadu_ps(right + frame);
+
+        _mm_storeu_ps(dst + 2 * frame, _mm_unpacklo_ps(l, r));
+        _mm_storeu_ps(dst + 2 * frame + 4, _mm_unpackhi_ps(l, r));
+    }
+
+    for (; frame < frames; ++frame)
+    {
+        dst[2 * frame] = left[frame];
+        dst[2 * frame + 1] = right[frame];
+    }
+}
+#elif MAKEASOUND_INTERLEAVE_NEON
+constexpr auto kVectorWidth = 4;
+
+template <>
+void transposeTile<4>(const float* src,
+                      int srcStride,
+                      float* dst,
+                      int dstStride) noexcept
+{
+    auto r01 = vtrnq_f32(vld1q_f32(src), vld1q_f32(src + srcStride));
+    auto r23 =
+        vtrnq_f32(vld1q_f32(src + 2 * srcStride), vld1q_f32(src + 3 * srcStride));
+
+    vst1q_f32(dst,
+              vcombine_f32(vget_low_f32(r01.val[0]), vget_low_f32(r23.val[0])));
+    vst1q_f32(dst + dstStride,
+              vcombine_f32(vget_low_f32(r01.val[1]), vget_low_f32(r23.val[1])));
+    vst1q_f32(dst + 2 * dstStride,
+              vcombine_f32(vget_high_f32(r01.val[0]), vget_high_f32(r23.val[0])));
+    vst1q_f32(dst + 3 * dstStride,
+              vcombine_f32(vget_high_f32(r01.val[1]), vget_high_f32(r23.val[1])));
+}
+
+void splitStereo(const float* src, float* left, float* right, int frames) noexcept
+{
+    auto frame = 0;
+
+    for (; frame + 4 <= frames; frame += 4)
+    {
+        auto pair = vld2q_f32(src + 2 * frame);
+        vst1q_f32(left + frame, pair.val[0]);
+        vst1q_f32(right + frame, pair.val[1]);
+    }
+
+    for (; frame < frames; ++frame)
+    {
+        left[frame] = src[2 * frame];
+        right[frame] = src[2 * frame + 1];
+    }
+}
+
+void joinStereo(const float* left,
+                const float* right,
+                float* dst,
+                int frames) noexcept
+{
+    auto frame = 0;
+
+    for (; frame + 4 <= frames; frame += 4)
+    {
+        auto pair = float32x4x2_t {};
+        pair.val[0] = vld1q_f32(left + frame);
+        pair.val[1] = vld1q_f32(right + frame);
+        vst2q_f32(dst + 2 * frame, pair);
+    }
+
+    for (; frame < frames; ++frame)
+    {
+        dst[2 * frame] = left[frame];
+        dst[2 * frame + 1] = right[frame];
+    }
+}
+#else
+constexpr auto kVectorWidth = 0;
+
+void splitStereo(const float* src, float* left, float* right, int frames) noexcept
+{
+    for (auto frame = 0; frame < frames; ++frame)
+    {
+        left[frame] = src[2 * frame];
+        right[frame] = src[2 * frame + 1];
+    }
+}
+
+void joinStereo(const float* left,
+                const float* right,
+                float* dst,
+                int frames) noexcept
+{
+    for (auto frame = 0; frame < frames; ++frame)
+    {
+        dst[2 * frame] = left[frame];
+        dst[2 * frame + 1] = right[frame];
+    }
+}
+#endif
+
+#if MAKEASOUND_INTERLEAVE_AVX
+template <>
+void transposeTile<8>(const float* src,
+                      int srcStride,
+                      float* dst,
+                      int dstStride) noexcept
+{
+    __m256 r[8];
+
+    for (auto i = 0; i < 8; ++i)
+        r[i] = _mm256_loadu_ps(src + i * srcStride);
+
+    auto t0 = _mm256_unpacklo_ps(r[0], r[1]);
+    auto t1 = _mm256_unpackhi_ps(r[0], r[1]);
+    auto t2 = _mm256_unpacklo_ps(r[2], r[3]);
+    auto t3 = _mm256_unpackhi_ps(r[2], r[3]);
+    auto t4 = _mm256_unpacklo_ps(r[4], r[5]);
+    auto t5 = _mm256_unpackhi_ps(r[4], r[5]);
+    auto t6 = _mm256_unpacklo_ps(r[6], r[7]);
+    auto t7 = _mm256_unpackhi_ps(r[6], r[7]);
+
+    auto s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+    auto s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    auto s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    auto s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+    auto s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+    auto s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+    auto s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+    auto s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+    _mm256_storeu_ps(dst, _mm256_permute2f128_ps(s0, s4, 0x20));
+    _mm256_storeu_ps(dst + dstStride, _mm256_permute2f128_ps(s1, s5, 0x20));
+    _mm256_storeu_ps(dst + 2 * dstStride, _mm256_permute2f128_ps(s2, s6, 0x20));
+    _mm256_storeu_ps(dst + 3 * dstStride, _mm256_permute2f128_ps(s3, s7, 0x20));
+    _mm256_storeu_ps(dst + 4 * dstStride, _mm256_permute2f128_ps(s0, s4, 0x31));
+    _mm256_storeu_ps(dst + 5 * dstStride, _mm256_permute2f128_ps(s1, s5, 0x31));
+    _mm256_storeu_ps(dst + 6 * dstStride, _mm256_permute2f128_ps(s2, s6, 0x31));
+    _mm256_storeu_ps(dst + 7 * dstStride, _mm256_permute2f128_ps(s3, s7, 0x31));
+}
+#endif
+
+// Columns [col, col + Width) for every row: whole tiles, then the rows left over.
+template <int Width>
+void transposeBand(const float* src,
+                   int srcStride,
+                   float* dst,
+                   int dstStride,
+                   int rows,
+                   int col) noexcept
+{
+    auto row = 0;
+
+    for (; row + Width <= rows; row += Width)
+        transposeTile<Width>(src + row * srcStride + col,
+                             srcStride,
+                             dst + col * dstStride + row,
+                             dstStride);
+
+    transposeScalar(src, srcStride, dst, dstStride, row, rows, col, col + Width);
+}
+
+// SrcStride/DstStride are the compile-time specialisations: for the common device
+// widths the per-tile address arithmetic folds to constants. 0 means "use the
+// runtime value".
+template <int SrcStride, int DstStride>
+void transpose(const float* src,
+               int srcStride,
+               float* dst,
+               int dstStride,
+               int rows,
+               int cols) noexcept
+{
+    if constexpr (SrcStride > 0)
+        srcStride = SrcStride;
+
+    if constexpr (DstStride > 0)
+        dstStride = DstStride;
+
+    auto col = 0;
+
+    // A band with fewer rows than a tile is all tail: a stereo pair out of a wide
+    // interface goes straight to the scalar loop instead of through empty bands.
+#if MAKEASOUND_INTERLEAVE_AVX
+    if (rows >= 8)
+        for (; col + 8 <= cols; col += 8)
+            transposeBand<8>(src, srcStride, dst, dstStride, rows, col);
+#endif
+
+    if constexpr (kVectorWidth == 4)
+        if (rows >= 4)
+            for (; col + 4 <= cols; col += 4)
+                transposeBand<4>(src, srcStride, dst, dstStride, rows, col);
+
+    transposeScalar(src, srcStride, dst, dstStride, 0, rows, col, cols);
+}
+} // namespace
+
+void deinterleaveSlice(const float* src,
+                       float* dst,
+                       int srcChannels,
+                       int firstChannel,
+                       int count,
+                       int frames) noexcept
+{
+    if (count <= 0 || frames <= 0)
+        return;
+
+    auto* slice = src + firstChannel;
+
+    switch (srcChannels)
+    {
+        case 1:
+            std::memcpy(
+                dst, slice, static_cast<std::size_t>(frames) * sizeof(float));
+            return;
+        case 2:
+            if (count == 2)
+                splitStereo(src, dst, dst + frames, frames);
+            else
+                transpose<2, 0>(slice, 2, dst, frames, frames, count);
+            return;
+        case 8:
+            transpose<8, 0>(slice, 8, dst, frames, frames, count);
+            return;
+        case 16:
+            transpose<16, 0>(slice, 16, dst, frames, frames, count);
+            return;
+        case 32:
+            transpose<32, 0>(slice, 32, dst, frames, frames, count);
+            return;
+        default:
+            transpose<0, 0>(slice, srcChannels, dst, frames, frames, count);
+            return;
+    }
+}
+
+void interleaveSlice(const float* src,
+                     float* dst,
+                     int dstChannels,
+                     int firstChannel,
+                     int count,
+                     int frames) noexcept
+{
+    if (count <= 0 || frames <= 0)
+        return;
+
+    auto* slice = dst + firstChannel;
+
+    switch (dstChannels)
+    {
+        case 1:
+            std::memcpy(
+                slice, src, static_cast<std::size_t>(frames) * sizeof(float));
+            return;
+        case 2:
+            if (count == 2)
+                joinStereo(src, src + frames, dst, frames);
+            else
+                transpose<0, 2>(src, frames, slice, 2, count, frames);
+            return;
+        case 8:
+            transpose<0, 8>(src, frames, slice, 8, count, frames);
+            return;
+        case 16:
+            transpose<0, 16>(src, frames, slice, 16, count, frames);
+            return;
+        case 32:
+            transpose<0, 32>(src, frames, slice, 32, count, frames);
+            return;
+        default:
+            transpose<0, 0>(src, frames, slice, dstChannels, count, frames);
+            return;
+    }
+}
+
+void clearOutsideSlice(float* dst,
+                       int dstChannels,
+                       int firstChannel,
+                       int count,
+                       int frames) noexcept
+{
+    if (count >= dstChannels || frames <= 0)
+        return;
+
+    if (count <= 0)
+    {
+        std::memset(
+            dst, 0, static_cast<std::size_t>(dstChannels * frames) * sizeof(float));
+        return;
+    }
+
+    auto before = static_cast<std::size_t>(firstChannel) * sizeof(float);
+    auto afterFirst = firstChannel + count;
+    auto after = static_cast<std::size_t>(dstChannels - afterFirst) * sizeof(float);
+
+    for (auto frame = 0; frame < frames; ++frame)
+    {
+        auto* samples = dst + frame * dstChannels;
+
+        if (before > 0)
+            std::memset(samples, 0, before);
+
+        if (after > 0)
+            std::memset(samples + afterFirst, 0, after);
+    }
+}
+
+void deinterleaveSliceScalar(const float* src,
+                             float* dst,
+                             int srcChannels,
+                             int firstChannel,
+                             int count,
+                             int frames) noexcept
+{
+    for (auto frame = 0; frame < frames; ++frame)
+        for (auto ch = 0; ch < count; ++ch)
+            dst[ch * frames + frame] =
+                src[frame * srcChannels + (firstChannel + ch)];
+}
+
+void interleaveSliceScalar(const float* src,
+                           float* dst,
+                           int dstChannels,
+                           int firstChannel,
+                           int count,
+                           int frames) noexcept
+{
+    for (auto frame = 0; frame < frames; ++frame)
+        for (auto ch = 0; ch < count; ++ch)
+            dst[frame * dstChannels + (firstChannel + ch)] =
+                src[ch * frames + frame];
+}
+
+} // namespace MakeASound
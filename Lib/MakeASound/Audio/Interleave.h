@@ -0,0 +1,55 @@
+#pragma once
+
+namespace MakeASound
+{
+
+// Conversions between a device's interleaved frames and the planar blocks callers
+// see. Only the slice [firstChannel, firstChannel + count) of each native frame is
+// touched, which is how a stereo pair is picked out of a multi-channel interface.
+// Pure data movement, so every kernel is bit-identical to the scalar reference;
+// allocation-free and safe on the audio thread.
+
+// src: `frames` frames of `srcChannels` interleaved samples.
+// dst: `count` planar channels of `frames` samples each.
+void deinterleaveSlice(const float* src,
+                       float* dst,
+                       int srcChannels,
+                       int firstChannel,
+                       int count,
+                       int frames) noexcept;
+
+// src: `count` planar channels of `frames` samples each.
+// dst: `frames` frames of `dstChannels` interleaved samples; channels outside the
+// slice are left as they were.
+void interleaveSlice(const float* src,
+                     float* dst,
+                     int dstChannels,
+                     int firstChannel,
+                     int count,
+                     int frames) noexcept;
+
+// Zeroes every channel of `frames` interleaved frames except the slice, for when the
+// slice is about to be written anyway and clearing it too would be wasted work.
+void clearOutsideSlice(float* dst,
+                       int dstChannels,
+                       int firstChannel,
+                       int count,
+                       int frames) noexcept;
+
+// The frame-by-channel loops the kernels above replace. Kept as the reference the
+// tests and benchmarks compare against.
+void deinterleaveSliceScalar(const float* src,
+                             float* dst,
+                             int srcChannels,
+                             int firstChannel,
+                             int count,
+                             int frames) noexcept;
+
+void interleaveSliceScalar(const float* src,
+                           float* dst,
+                           int dstChannels,
+                           int firstChannel,
+                           int count,
+                           int frames) noexcept;
+
+} // namespace MakeASound
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+namespace MakeASound
+{
+
+// One channel of an interleaved block: every `stride`-th sample, starting at `data`.
+template <typename T>
+class StridedChannel
+{
+public:
+    class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::remove_const_t<T>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T*;
+        using reference = T&;
+
+        Iterator() noexcept = default;
+        Iterator(T* ptrToUse, int strideToUse) noexcept
+            : ptr(ptrToUse)
+            , stride(strideToUse)
+        {
+        }
+
+        T& operator*() const noexcept { return *ptr; }
+
+        Iterator& operator++() noexcept
+        {
+            ptr += stride;
+            return *this;
+        }
+
+        Iterator operator++(int) noexcept
+        {
+            auto previous = *this;
+            ptr += stride;
+            return previous;
+        }
+
+        bool operator==(const Iterator& other) const noexcept
+        {
+            return ptr == other.ptr;
+        }
+
+    private:
+        T* ptr = nullptr;
+        int stride = 1;
+    };
+
+    StridedChannel() noexcept = default;
+    StridedChannel(T* dataToUse, int strideToUse, int numSamplesToUse) noexcept
+        : data(dataToUse)
+        , stride(strideToUse)
+        , numSamples(numSamplesToUse)
+    {
+    }
+
+    int size() const noexcept { return numSamples; }
+    bool empty() const noexcept { return numSamples == 0; }
+    int getStride() const noexcept { return stride; }
+
+    T& operator[](int sample) const noexcept { return data[sample * stride]; }
+
+    Iterator begin() const noexcept { return {data, stride}; }
+    Iterator end() const noexcept { return {data + numSamples * stride, stride}; }
+
+private:
+    T* data = nullptr;
+    int stride = 1;
+    int numSamples = 0;
+};
+
+// A non-owning view over an interleaved (frame-major) audio block, as the device
+// delivers it: all channels of frame 0, then all channels of frame 1, and so on.
+// The view may cover only a slice of each frame — `stride` is the device's full
+// width, and `data` points at the first selected channel of frame 0 — so the samples
+// of one frame are contiguous, but a channel's are `stride` apart.
+template <typename T>
+class InterleavedView
+{
+public:
+    InterleavedView() noexcept = default;
+
+    InterleavedView(T* dataToUse,
+                    int numChannelsToUse,
+                    int numSamplesToUse,
+                    int strideToUse) noexcept
+        : data(dataToUse)
+        , numChannels(numChannelsToUse)
+        , numSamples(numSamplesToUse)
+        , stride(strideToUse)
+    {
+    }
+
+    int getNumChannels() const noexcept { return numChannels; }
+
+    // Frames, i.e. samples per channel.
+    int getNumSamples() const noexcept { return numSamples; }
+
+    // Distance between one frame and the next, in samples. Equal to getNumChannels()
+    // only when the view covers the device's every channel.
+    int getStride() const noexcept { return stride; }
+
+    bool isEmpty() const noexcept { return numChannels == 0 || numSamples == 0; }
+
+    T* getData() const noexcept { return data; }
+
+    // getNumChannels() contiguous samples.
+    T* getFrame(int frame) const noexcept { return data + frame * stride; }
+
+    StridedChannel<T> getChannel(int channel) const noexcept
+    {
+        return {data + channel, stride, numSamples};
+    }
+
+    T& getSample(int channel, int frame) const noexcept
+    {
+        return data[frame * stride + channel];
+    }
+
+private:
+    T* data = nullptr;
+    int numChannels = 0;
+    int numSamples = 0;
+    int stride = 0;
+};
+
+using InterleavedBuffer = InterleavedView<float>;
+
+} // namespace MakeASound
@@ -1,17 +1,18 @@
 #pragma once
 
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
 namespace MakeASound::Algorithms
 {
 
 // Allocation-free, so it is safe on the audio thread; the unconditional
 // noexcept assumes the element copy and the comparator never throw.
 // O(N) for already-sorted input, O(N^2) worst case.
-template <class Container, class Compare>
-void stableInsertionSort(Container& c, Compare less) noexcept
+template <class It, class Compare>
+void stableInsertionSort(It first, It last, Compare less) noexcept
 {
-    auto first = c.begin();
-    auto last = c.end();
-
     for (auto it = first + 1; it < last; ++it)
     {
         auto key = *it;
@@ -25,6 +26,12 @@ void stableInsertionSort(Container& c, Compare less) noexcept
     }
 }
 
+template <class Container, class Compare>
+void stableInsertionSort(Container& c, Compare less) noexcept
+{
+    stableInsertionSort(c.begin(), c.end(), less);
+}
+
 template <class Container>
 void stableInsertionSort(Container& c) noexcept
 {
@@ -32,4 +39,80 @@ void stableInsertionSort(Container& c) noexcept
                         [](const auto& a, const auto& b) noexcept { return a < b; });
 }
 
+namespace Detail
+{
+// End of the ascending run that starts at `from`.
+template <class It, class Compare>
+It runEnd(It from, It last, Compare& less) noexcept
+{
+    if (from == last)
+        return last;
+
+    auto it = from + 1;
+
+    while (it < last && !less(*it, *(it - 1)))
+        ++it;
+
+    return it;
+}
+} // namespace Detail
+
+// Stable and allocation-free given `scratch`, which must have room for
+// last - first elements. Merges the ascending runs already in the input pairwise,
+// so k runs — k MIDI ports drained one after another — take log2(k) passes over
+// the data: O(N log k), O(N) when already sorted, O(N log N) at worst. Short
+// inputs, where the passes cost more than they save, go to insertion sort.
+template <class It, class ScratchIt, class Compare>
+void stableRunMergeSort(It first, It last, ScratchIt scratch, Compare less) noexcept
+{
+    constexpr auto insertionSortLimit = 16;
+
+    auto size = last - first;
+
+    if (size <= insertionSortLimit)
+        return stableInsertionSort(first, last, less);
+
+    if (std::is_sorted(first, last, less))
+        return;
+
+    // Ping-pong between the input and the scratch, a pass at a time, until one run
+    // is left; std::merge takes from the first range on ties, which keeps it stable.
+    auto passes = 0;
+
+    for (;;)
+    {
+        auto runs = 0;
+
+        auto mergePass = [&](auto src, auto dst)
+        {
+            for (auto i = decltype(size) {0}; i < size; ++runs)
+            {
+                auto mid = Detail::runEnd(src + i, src + size, less) - src;
+                auto end = Detail::runEnd(src + mid, src + size, less) - src;
+
+                std::merge(
+                    src + i, src + mid, src + mid, src + end, dst + i, less);
+                i = end;
+            }
+        };
+
+        if (passes++ % 2 == 0)
+            mergePass(first, scratch);
+        else
+            mergePass(scratch, first);
+
+        if (runs == 1)
+            break;
+    }
+
+    if (passes % 2 == 1)
+        std::copy(scratch, scratch + size, first);
+}
+
+template <class Container, class Scratch, class Compare>
+void stableRunMergeSort(Container& c, Scratch& scratch, Compare less) noexcept
+{
+    stableRunMergeSort(c.begin(), c.end(), std::begin(scratch), less);
+}
+
 } // namespace MakeASound::Algorithms
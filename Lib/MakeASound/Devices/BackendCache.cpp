@@ -0,0 +1,210 @@
+#include "BackendCache.h"
+
+#include <cctype>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+
+#if defined(_WIN32)
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace MakeASound
+{
+namespace
+{
+namespace fs = std::filesystem;
+
+std::string getEnvironment(const char* name)
+{
+#if defined(_WIN32)
+    // getenv is deprecated on MSVC.
+    char* value = nullptr;
+    auto size = std::size_t {0};
+
+    if (_dupenv_s(&value, &size, name) != 0 || value == nullptr)
+        return {};
+
+    auto result = std::string {value};
+    std::free(value);
+    return result;
+#else
+    auto* value = std::getenv(name);
+    return value != nullptr ? value : "";
+#endif
+}
+
+std::string getHostName()
+{
+#if defined(_WIN32)
+    return getEnvironment("COMPUTERNAME");
+#else
+    char name[256] {};
+
+    if (gethostname(name, sizeof(name) - 1) != 0)
+        return {};
+
+    return name;
+#endif
+}
+
+// What setBackendCacheDirectory() asked for, if anything. A function-local static,
+// so a host or a test may set it from a static initialiser of its own.
+struct CacheDirectoryOverride
+{
+    std::mutex mutex;
+    std::optional<fs::path> directory;
+};
+
+CacheDirectoryOverride& getCacheDirectoryOverride()
+{
+    static auto instance = CacheDirectoryOverride {};
+    return instance;
+}
+
+// Where each platform keeps caches a user can delete at no cost. Empty when there is
+// nowhere to put one, which turns caching off.
+fs::path getCacheDirectory()
+{
+    {
+        auto& chosen = getCacheDirectoryOverride();
+        auto lock = std::lock_guard(chosen.mutex);
+
+        if (chosen.directory.has_value())
+            return *chosen.directory;
+    }
+
+#if defined(_WIN32)
+    auto base = getEnvironment("LOCALAPPDATA");
+    return base.empty() ? fs::path {} : fs::path {base};
+#elif defined(__APPLE__)
+    auto home = getEnvironment("HOME");
+    return home.empty() ? fs::path {} : fs::path {home} / "Library" / "Caches";
+#else
+    if (auto xdg = getEnvironment("XDG_CACHE_HOME"); !xdg.empty())
+        return xdg;
+
+    auto home = getEnvironment("HOME");
+    return home.empty() ? fs::path {} : fs::path {home} / ".cache";
+#endif
+}
+
+fs::path getCacheFile()
+{
+    auto directory = getCacheDirectory();
+    auto host = getHostName();
+
+    if (directory.empty() || host.empty())
+        return {};
+
+    // A host name is a file name almost everywhere; anything else is dropped.
+    auto safeHost = std::string {};
+
+    for (auto c: host)
+        if (std::isalnum(static_cast<unsigned char>(c)) != 0 || c == '-'
+            || c == '.')
+            safeHost += c;
+
+    return directory / "MakeASound" / ("backends-" + safeHost + ".txt");
+}
+
+// Unique to this process and thread, so two writers never share a temporary file.
+std::string getWriterTag()
+{
+#if defined(_WIN32)
+    auto process = _getpid();
+#else
+    auto process = getpid();
+#endif
+    auto thread = std::hash<std::thread::id> {}(std::this_thread::get_id());
+
+    return std::to_string(process) + "-" + std::to_string(thread);
+}
+} // namespace
+
+std::optional<Vector<Backend>> loadCachedBackends()
+{
+    auto file = getCacheFile();
+
+    if (file.empty())
+        return std::nullopt;
+
+    auto stream = std::ifstream {file};
+
+    if (!stream)
+        return std::nullopt;
+
+    // One display name a line, as getBackendName spells it. A line that names no
+    // backend is a file from some other version: ignore the lot rather than offer
+    // half a list.
+    auto backends = Vector<Backend> {};
+
+    for (auto line = std::string {}; std::getline(stream, line);)
+    {
+        if (line.empty())
+            continue;
+
+        auto backend = getBackendFromName(line);
+
+        if (!backend.has_value())
+            return std::nullopt;
+
+        backends.add(*backend);
+    }
+
+    return backends;
+}
+
+void saveCachedBackends(const Vector<Backend>& backends)
+{
+    auto file = getCacheFile();
+
+    if (file.empty())
+        return;
+
+    auto error = std::error_code {};
+    fs::create_directories(file.parent_path(), error);
+
+    if (error)
+        return;
+
+    // Written aside and renamed over, so another instance starting up never reads a
+    // half-written list. The temporary file is this writer's own: two instances
+    // saving at once each rename a whole list, and the last one wins.
+    auto temporary = file;
+    temporary += "." + getWriterTag() + ".tmp";
+
+    auto written = false;
+
+    {
+        auto stream = std::ofstream {temporary, std::ios::trunc};
+
+        for (auto backend: backends)
+            stream << getBackendName(backend) << '\n';
+
+        written = static_cast<bool>(stream);
+    }
+
+    if (written)
+        fs::rename(temporary, file, error);
+
+    if (!written || error)
+        fs::remove(temporary, error);
+}
+
+void setBackendCacheDirectory(const fs::path& directory)
+{
+    auto& chosen = getCacheDirectoryOverride();
+    auto lock = std::lock_guard(chosen.mutex);
+
+    chosen.directory = directory;
+}
+
+} // namespace MakeASound
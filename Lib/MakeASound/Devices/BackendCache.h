@@ -0,0 +1,26 @@
+#pragma once
+
+#include "../Common/Common.h"
+#include "DeviceInfo.h"
+
+#include <filesystem>
+#include <optional>
+
+namespace MakeASound
+{
+
+// What the last backend probe on this machine found, kept in the user's cache
+// directory so a host can offer it the moment it starts rather than after this
+// run's probe. The file is named for the host as well, since a home directory may be
+// shared between machines with different drivers. nullopt when there is no cache yet
+// or it doesn't read back; an empty list is a probe that found nothing.
+std::optional<Vector<Backend>> loadCachedBackends();
+
+// Best effort: a cache that can't be written only means the next start goes without.
+void saveCachedBackends(const Vector<Backend>& backends);
+
+// Replaces the platform's cache directory for both of the above; empty turns the
+// cache off.
+void setBackendCacheDirectory(const std::filesystem::path& directory);
+
+} // namespace MakeASound
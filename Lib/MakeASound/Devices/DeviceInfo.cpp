@@ -189,18 +189,41 @@ int StreamConfig::getOutputChannels() const { return getNumChannels(output); }
 
 Buffer AudioCallbackInfo::getInput() const
 {
+    if (interleaved)
+        return {};
+
     return {inputBuffer, numInputs, numSamples};
 }
 
 Buffer AudioCallbackInfo::getOutput()
 {
+    if (interleaved)
+        return {};
+
     return {outputBuffer, numOutputs, numSamples};
 }
 
+InterleavedView<const float> AudioCallbackInfo::getInterleavedInput() const
+{
+    if (!interleaved)
+        return {};
+
+    return {inputBuffer, numInputs, numSamples, inputStride};
+}
+
+InterleavedBuffer AudioCallbackInfo::getInterleavedOutput()
+{
+    if (!interleaved)
+        return {};
+
+    return {outputBuffer, numOutputs, numSamples, outputStride};
+}
+
 bool AudioCallbackInfo::operator==(const AudioCallbackInfo& other) const
 {
     return numInputs == other.numInputs && numOutputs == other.numOutputs
-           && sampleRate == other.sampleRate
+           && interleaved == other.interleaved && inputStride == other.inputStride
+           && outputStride == other.outputStride && sampleRate == other.sampleRate
            && maxBlockSize == other.maxBlockSize;
 }
 
@@ -4,7 +4,9 @@
 
 #include "../Common/Common.h"
 #include "../Audio/Buffer.h"
+#include "../Audio/InterleavedBuffer.h"
 
+#include <cstdint>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -67,8 +69,9 @@ struct DeviceInfo
     int id {};
     std::string name;
 
-    // Ids are handed out per-API, so a DeviceInfo only means anything to the manager
-    // that enumerated it — see DeviceManager::setBackend.
+    // Ids come from the API's own name for the device plus its display name: stable
+    // while other devices come and go, and from run to run, so a saved config can
+    // keep one. Another API has other ids — see DeviceManager::setBackend.
     Backend backend {Backend::Unknown};
 
     int outputChannels {};
@@ -133,11 +136,25 @@ struct StreamParameters
 
 struct Flags
 {
-    MIRO_REFLECT(nonInterleaved, minimizeLatency, hogDevice)
+    MIRO_REFLECT(
+        nonInterleaved, minimizeLatency, hogDevice, skipOutputClear, fixedBlockSize)
 
+    // Off hands the callback the device's own interleaved buffers (see
+    // AudioCallbackInfo::getInterleavedOutput) instead of planar copies of them.
     bool nonInterleaved = true;
     bool minimizeLatency = false;
     bool hogDevice = false;
+
+    // A promise that the callback writes every output sample of every block. The
+    // output then arrives holding whatever was there before instead of silence, and
+    // the library only zeroes the device channels outside the selected slice — two
+    // fewer full-buffer clears per block, which adds up at small block sizes.
+    bool skipOutputClear = false;
+
+    // Every block is exactly StreamConfig::maxBlockSize frames, whatever periods the
+    // device delivers. They are queued internally to get there, which costs up to
+    // maxBlockSize - 1 frames of latency, included in AudioCallbackInfo::latency.
+    bool fixedBlockSize = false;
 };
 
 struct StreamOptions
@@ -189,11 +206,18 @@ struct StreamConfig
 
 struct AudioCallbackInfo
 {
-    // Planar views; the backend owns the interleaved<->planar conversion, so
-    // callers only ever see planar data.
+    // Planar views; the backend owns the interleaved<->planar conversion. Empty when
+    // the stream was opened interleaved.
     Buffer getInput() const;
     Buffer getOutput();
 
+    // The device's native buffers, no copies in between — only when the stream was
+    // opened with Flags::nonInterleaved off; empty otherwise. They cover just the
+    // selected channels, and output channels outside them arrive silent.
+    InterleavedView<const float> getInterleavedInput() const;
+    InterleavedBuffer getInterleavedOutput();
+
+    // Compares the shape only — the fields that move generation when they change.
     bool operator==(const AudioCallbackInfo& other) const;
     bool operator!=(const AudioCallbackInfo& other) const;
 
@@ -202,16 +226,33 @@ struct AudioCallbackInfo
     float* outputBuffer = nullptr;
     float* inputBuffer = nullptr;
     int numSamples {};
+
+    // Set for an interleaved stream, where the buffers above point into the device's
+    // frames and consecutive frames are inputStride / outputStride samples apart.
+    bool interleaved = false;
+    int inputStride = 0;
+    int outputStride = 0;
+
     double streamTime {};
     AudioCallbackStatus status = AudioCallbackStatus::OK;
 
     int sampleRate = 0;
+
+    // numSamples never exceeds it: a longer device period arrives as several blocks.
+    // Under Flags::fixedBlockSize it is always equal.
     int maxBlockSize = 0;
+
+    // Frames: the device's buffering, plus what Flags::fixedBlockSize adds.
     int latency = 0;
 
-    // "Re-derive whatever you cached about this stream." Raised when the shape
-    // (channels, sample rate, block size) differs from the previous callback, and on
-    // the first callback after a reroute or interruption, which leave it unchanged.
+    // Changes exactly when the stream's shape (channels, layout, sample rate, block
+    // size) or route (a reroute, an interruption, a backend switch) does, and is the
+    // same on every block in between — a host caching per-stream state can key it on
+    // this one integer.
+    std::uint64_t generation = 0;
+
+    // "Re-derive whatever you cached about this stream." Raised on the first block
+    // of a new generation, and on the first block a newly installed callback sees.
     bool dirty = false;
     int errorCode = 0;
 };
@@ -1,4 +1,5 @@
 #include "DeviceManager.h"
+#include "BackendCache.h"
 #include "../MiniAudio/MiniAudioDeviceManager.h"
 
 namespace MakeASound
@@ -29,11 +30,26 @@ DeviceInfo DeviceManager::getDefaultOutputDevice() const
     return pimpl->getDefaultOutputDevice();
 }
 
+std::uint64_t DeviceManager::getDevicesVersion() const
+{
+    return pimpl->getDevicesVersion();
+}
+
+void DeviceManager::refreshDevices() const
+{
+    pimpl->refreshDevices();
+}
+
 Vector<Backend> DeviceManager::getAvailableBackends() const
 {
     return pimpl->getAvailableBackends();
 }
 
+void DeviceManager::setCacheDirectory(const std::string& directory)
+{
+    setBackendCacheDirectory(directory);
+}
+
 Backend DeviceManager::getBackend() const
 {
     return pimpl->getBackend();
@@ -43,11 +59,9 @@ Error DeviceManager::setBackend(Backend backendToUse)
 {
     auto error = pimpl->setBackend(backendToUse);
 
-    // The backend dropped its config; drop ours with it, and the remembered callback
-    // shape, so the next stream's first callback reads as dirty rather than being
-    // compared against one from a different API.
+    // The backend dropped its config, and the remembered callback shape with it;
+    // drop ours too.
     config = {};
-    prevInfo = {};
 
     return error;
 }
@@ -77,17 +91,28 @@ StreamConfig DeviceManager::getDefaultConfig() const
 
 Error DeviceManager::setConfig(const StreamConfig& configToUse)
 {
-    stop();
     config = configToUse;
+
+    // What the open device can take goes to it live, with no dropout; anything else
+    // is a new device.
+    if (pimpl->hasCallback() && pimpl->tryReconfigure(config))
+        return Error::NoError;
+
+    stop();
     return openStream();
 }
 
 Error DeviceManager::start(const StreamConfig& configToUse, const Callback& cb)
 {
-    callback = cb;
+    setCallback(cb);
     return setConfig(configToUse);
 }
 
+void DeviceManager::setCallback(const Callback& cb) const
+{
+    pimpl->setCallback(cb);
+}
+
 void DeviceManager::stop() const
 {
     pimpl->stop();
@@ -127,22 +152,9 @@ int DeviceManager::getStreamSampleRate() const
 
 Error DeviceManager::openStream()
 {
-    if (!callback)
+    if (!pimpl->hasCallback())
         return Error::INVALID_USE;
 
-    auto actualCallback = [this](AudioCallbackInfo& info)
-    {
-        if (prevInfo != info)
-        {
-            prevInfo = info;
-            info.dirty = true;
-        }
-
-        callback(info);
-    };
-
-    pimpl->callback = actualCallback;
-
     return pimpl->start(config);
 }
 
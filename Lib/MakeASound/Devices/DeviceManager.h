@@ -3,6 +3,9 @@
 #include "../Common/Common.h"
 #include "DeviceInfo.h"
 
+#include <cstdint>
+#include <string>
+
 namespace MakeASound
 {
 namespace MiniAudio
@@ -10,6 +13,9 @@ namespace MiniAudio
 struct DeviceManager;
 }
 
+// Managers on the same backend share one connection to it and one device list, so
+// a process running several streams pays for neither more than once; each has its
+// own device and stream.
 class DeviceManager
 {
 public:
@@ -20,10 +26,28 @@ public:
     DeviceInfo getDefaultInputDevice() const;
     DeviceInfo getDefaultOutputDevice() const;
 
-    // Probed once and remembered, so a JACK server started after the manager was
-    // constructed is not picked up; construct another one to look again.
+    // The three above answer from a list a background thread keeps current, so they
+    // never wait on the OS or on a stream being opened. The version moves only when
+    // that list changes, or setBackend() swaps it for another driver's: poll it, and
+    // rebuild a device menu only when it does.
+    std::uint64_t getDevicesVersion() const;
+
+    // Asks for a fresh look now rather than at the next interval; returns at once,
+    // and the version moves when the new list lands, if it differs.
+    void refreshDevices() const;
+
+    // Probed in the background when the first manager is constructed, every driver
+    // at once and each given two seconds, so a hung sound server can't hold up
+    // startup; managers constructed while one is alive share that answer. Until it
+    // is in, the answer is what the last run on this machine found. A JACK server
+    // started later shows up once every manager is gone and another is constructed.
     Vector<Backend> getAvailableBackends() const;
 
+    // Where that last run's answer is kept: the platform's cache directory unless
+    // this names another - a sandboxed app's container, a test's scratch directory -
+    // and nowhere if it is empty. Set it before the first manager is constructed.
+    static void setCacheDirectory(const std::string& directory);
+
     // Never Unknown once construction succeeded — the default is one of them.
     Backend getBackend() const;
 
@@ -38,10 +62,23 @@ public:
 
     // A failure leaves no stream running and the manager usable. A config naming a
     // device that is merely busy comes back on its own once it frees up.
+    //
+    // On a running stream, a config that only moves the channel slice — firstChannel
+    // or nChannels on a side already open — is taken up at the next block without
+    // re-opening the device, and that block reads as dirty; so is one identical to
+    // the running config, which makes start() with a new callback a callback swap.
+    // Anything else closes the device and opens another.
     Error setConfig(const StreamConfig& configToUse);
     Error start(const StreamConfig& configToUse, const Callback& cb);
     void stop() const;
 
+    // Swaps the callback without touching the device: a running stream calls the
+    // new one from the next block on, with no dropout, and its first block reads as
+    // dirty. Lock-free on the audio thread; the callback it replaces is destroyed
+    // later on a non-audio thread, so it may own anything. Call from any thread but
+    // the audio one.
+    void setCallback(const Callback& cb) const;
+
     bool isRunning() const;
     Error getLastError() const;
 
@@ -61,8 +98,6 @@ public:
 private:
     Error openStream();
 
-    AudioCallbackInfo prevInfo;
-    Callback callback;
     StreamConfig config;
 
     OwningPointer<MiniAudio::DeviceManager> pimpl;
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+
+namespace MakeASound
+{
+
+inline double toSeconds(std::chrono::steady_clock::time_point time) noexcept
+{
+    return std::chrono::duration<double>(time.time_since_epoch()).count();
+}
+
+inline std::chrono::steady_clock::time_point
+    fromSeconds(double seconds) noexcept
+{
+    auto since = std::chrono::duration<double>(seconds);
+    return std::chrono::steady_clock::time_point {
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(since)};
+}
+
+// A straight line y = intercept + slope * x through pairs of readings of two clocks
+// that run at nearly, but not exactly, the same rate: the audio device's stream time
+// and steady_clock read when its callback ran, say. The slope is their drift; the
+// line is the jitter-free reading of one clock from the other.
+//
+// Weighted least squares, each new reading multiplying the weight of the ones
+// before by `forgetting`, so the fit follows drift that changes and remembers about
+// 1 / (1 - forgetting) readings. The slope leans towards 1 until the readings span
+// enough time to say otherwise, so the first reading already gives a usable line.
+// Sums are kept relative to the newest reading, which keeps them small however long
+// the clocks have run. Allocation-free and constant-time.
+class LinearClockFit
+{
+public:
+    explicit LinearClockFit(double forgettingToUse = 0.998) noexcept
+        : forgetting(forgettingToUse)
+    {
+    }
+
+    void reset() noexcept { *this = LinearClockFit(forgetting); }
+    bool empty() const noexcept { return weight == 0.0; }
+
+    void add(double x, double y) noexcept
+    {
+        if (empty())
+        {
+            originX = x;
+            originY = y;
+        }
+
+        // Move the origin to the new reading, then fade the old ones.
+        auto dx = x - originX;
+        auto dy = y - originY;
+
+        sumXY += dx * dy * weight - dx * sumY - dy * sumX;
+        sumXX += dx * dx * weight - 2.0 * dx * sumX;
+        sumX -= dx * weight;
+        sumY -= dy * weight;
+        originX = x;
+        originY = y;
+
+        weight = weight * forgetting + 1.0;
+        sumX *= forgetting;
+        sumY *= forgetting;
+        sumXX *= forgetting;
+        sumXY *= forgetting;
+    }
+
+    // dy/dx; 1 before any reading.
+    double getSlope() const noexcept
+    {
+        if (empty())
+            return 1.0;
+
+        auto varianceX = sumXX - sumX * sumX / weight;
+        auto covariance = sumXY - sumX * sumY / weight;
+        auto slope = (covariance + prior) / (varianceX + prior);
+
+        return slope > 0.0 ? slope : 1.0;
+    }
+
+    // y for x, and back. Undefined before any reading.
+    double map(double x) const noexcept
+    {
+        return meanY() + getSlope() * (x - meanX());
+    }
+
+    double unmap(double y) const noexcept
+    {
+        return meanX() + (y - meanY()) / getSlope();
+    }
+
+private:
+    // Pulls the slope towards 1 with the pull of readings spread 100 ms apart.
+    static constexpr double prior = 0.01;
+
+    double meanX() const noexcept { return originX + sumX / weight; }
+    double meanY() const noexcept { return originY + sumY / weight; }
+
+    double forgetting;
+    double originX = 0.0;
+    double originY = 0.0;
+    double weight = 0.0;
+    double sumX = 0.0;
+    double sumY = 0.0;
+    double sumXX = 0.0;
+    double sumXY = 0.0;
+};
+
+// Arrival times for one MIDI input, rebuilt from the device's own timestamps. RtMidi
+// hands each message the time since the one before, taken where the driver
+// received it; by the time its callback runs, the message has also waited on
+// scheduling, by a different amount every time. Added up, those deltas are the
+// device's clock; arrival minus device time is that wait plus a constant. The
+// smallest offset seen is the message that waited least, so device time plus that
+// floor is when each message really came in, never later than its callback.
+//
+// The floor creeps up by maxDrift of the time that passes, so it follows a device
+// clock running slower than steady_clock; a faster one pulls the floor down by
+// itself. A message that disagrees with the floor by more than resyncThreshold means
+// the timestamps can't be trusted across that gap - a reset, a stall - and the
+// floor restarts from it. Call from the one thread that receives the port's input.
+class ArrivalDejitter
+{
+public:
+    static constexpr double maxDrift = 1.0e-4;
+    static constexpr double resyncThreshold = 0.01;
+
+    // delta: seconds since the previous message by the device's clock. arrival:
+    // steady_clock seconds now. Returns the corrected arrival, in steady_clock
+    // seconds, at most `arrival`.
+    double stamp(double delta, double arrival) noexcept
+    {
+        auto elapsed = std::max(0.0, delta);
+        deviceTime += elapsed;
+
+        auto offset = arrival - deviceTime;
+
+        if (!started)
+        {
+            floor = offset;
+            started = true;
+        }
+        else
+        {
+            floor += maxDrift * elapsed;
+
+            if (offset < floor || offset - floor > resyncThreshold)
+                floor = offset;
+        }
+
+        return deviceTime + floor;
+    }
+
+    void reset() noexcept { *this = {}; }
+
+private:
+    double deviceTime = 0.0;
+    double floor = 0.0;
+    bool started = false;
+};
+
+} // namespace MakeASound
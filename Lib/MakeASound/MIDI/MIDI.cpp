@@ -6,7 +6,6 @@
 #include <cassert>
 #include <cmath>
 #include <cstdio>
-#include <cstring>
 
 namespace MakeASound::MIDI
 {
@@ -24,172 +23,54 @@ void Buffer::sortByOffset() noexcept
     Algorithms::stableInsertionSort(*this);
 }
 
-Event Event::noteOn(int channel,
-                    int pitch,
-                    float velocity,
-                    int sampleOffset) noexcept
+void Buffer::sortByOffset(std::span<Event> scratch) noexcept
 {
-    auto event = Event {};
-    event.sampleOffset = sampleOffset;
-    event.channel = channel;
-    event.payload = NoteOn {.pitch = pitch, .velocity = velocity};
-    return event;
-}
-
-Event Event::noteOff(int channel,
-                     int pitch,
-                     float velocity,
-                     int sampleOffset) noexcept
-{
-    auto event = Event {};
-    event.sampleOffset = sampleOffset;
-    event.channel = channel;
-    event.payload = NoteOff {.pitch = pitch, .velocity = velocity};
-    return event;
-}
-
-Event Event::controlChange(int channel,
-                           int controller,
-                           float value,
-                           int sampleOffset) noexcept
-{
-    auto event = Event {};
-    event.sampleOffset = sampleOffset;
-    event.channel = channel;
-    event.payload = ControlChange {.controller = controller, .value = value};
-    return event;
-}
-
-Event Event::pitchBend(int channel, float value, int sampleOffset) noexcept
-{
-    auto event = Event {};
-    event.sampleOffset = sampleOffset;
-    event.channel = channel;
-    event.payload = PitchBend {.value = value};
-    return event;
-}
-
-Event Event::channelAftertouch(int channel,
-                               float pressure,
-                               int sampleOffset) noexcept
-{
-    auto event = Event {};
-    event.sampleOffset = sampleOffset;
-    event.channel = channel;
-    event.payload = ChannelAftertouch {.pressure = pressure};
-    return event;
-}
-
-Event Event::polyAftertouch(int channel,
-                            int pitch,
-                            float pressure,
-                            int sampleOffset) noexcept
-{
-    auto event = Event {};
-    event.sampleOffset = sampleOffset;
-    event.channel = channel;
-    event.payload = PolyAftertouch {.pitch = pitch, .pressure = pressure};
-    return event;
-}
+    if (static_cast<std::size_t>(size()) > scratch.size())
+        return sortByOffset();
 
-Event Event::programChange(int channel, int program, int sampleOffset) noexcept
-{
-    auto event = Event {};
-    event.sampleOffset = sampleOffset;
-    event.channel = channel;
-    event.payload = ProgramChange {.program = program};
-    return event;
+    Algorithms::stableRunMergeSort(*this,
+                                   scratch,
+                                   [](const Event& a, const Event& b) noexcept
+                                   { return a < b; });
 }
 
 Event Event::sysEx(const uint8_t* bytes, int size, int sampleOffset) noexcept
 {
     auto event = Event {};
     event.sampleOffset = sampleOffset;
-    event.channel = -1;
+    event.status = 0xF0;
 
-    auto sysEx = SysEx {};
+    auto framed = bytes != nullptr && size >= 2 && bytes[0] == 0xF0
+                  && bytes[size - 1] == 0xF7;
+
+    auto* payload = framed ? bytes + 1 : bytes;
+    auto payloadSize = framed ? size - 2 : size;
 
     // Malformed input still yields an event, so audio-thread callers can
     // push it without branching.
-    assert(bytes != nullptr && size >= 0 && size <= SysEx::maxBytes
-           && "SysEx payload exceeds MIDI::SysEx::maxBytes");
+    assert(bytes != nullptr && payloadSize >= 0
+           && payloadSize <= SysEx::maxPayloadBytes
+           && "SysEx payload exceeds MIDI::SysEx::maxPayloadBytes");
+
+    if (payload == nullptr || payloadSize <= 0
+        || payloadSize > SysEx::maxPayloadBytes)
+        return event;
 
-    if (bytes != nullptr && size > 0 && size <= SysEx::maxBytes)
+    event.index = static_cast<std::uint8_t>(payloadSize | (framed ? framedFlag : 0));
+
+    for (auto i = 0; i < payloadSize; ++i)
     {
-        std::memcpy(sysEx.data.data(), bytes, static_cast<size_t>(size));
-        sysEx.size = size;
+        auto byte = payload[i];
+
+        if (i < static_cast<int>(event.extra.size()))
+            event.extra[static_cast<std::size_t>(i)] = byte;
+        else
+            event.data |= static_cast<std::uint32_t>(byte) << (8 * (i - 2));
     }
 
-    event.payload = sysEx;
     return event;
 }
 
-bool Event::isNoteOn() const noexcept
-{
-    return std::holds_alternative<NoteOn>(payload);
-}
-bool Event::isNoteOff() const noexcept
-{
-    return std::holds_alternative<NoteOff>(payload);
-}
-bool Event::isControlChange() const noexcept
-{
-    return std::holds_alternative<ControlChange>(payload);
-}
-bool Event::isPitchBend() const noexcept
-{
-    return std::holds_alternative<PitchBend>(payload);
-}
-bool Event::isChannelAftertouch() const noexcept
-{
-    return std::holds_alternative<ChannelAftertouch>(payload);
-}
-bool Event::isPolyAftertouch() const noexcept
-{
-    return std::holds_alternative<PolyAftertouch>(payload);
-}
-bool Event::isProgramChange() const noexcept
-{
-    return std::holds_alternative<ProgramChange>(payload);
-}
-bool Event::isSysEx() const noexcept
-{
-    return std::holds_alternative<SysEx>(payload);
-}
-
-const NoteOn* Event::asNoteOn() const noexcept
-{
-    return std::get_if<NoteOn>(&payload);
-}
-const NoteOff* Event::asNoteOff() const noexcept
-{
-    return std::get_if<NoteOff>(&payload);
-}
-const ControlChange* Event::asControlChange() const noexcept
-{
-    return std::get_if<ControlChange>(&payload);
-}
-const PitchBend* Event::asPitchBend() const noexcept
-{
-    return std::get_if<PitchBend>(&payload);
-}
-const ChannelAftertouch* Event::asChannelAftertouch() const noexcept
-{
-    return std::get_if<ChannelAftertouch>(&payload);
-}
-const PolyAftertouch* Event::asPolyAftertouch() const noexcept
-{
-    return std::get_if<PolyAftertouch>(&payload);
-}
-const ProgramChange* Event::asProgramChange() const noexcept
-{
-    return std::get_if<ProgramChange>(&payload);
-}
-const SysEx* Event::asSysEx() const noexcept
-{
-    return std::get_if<SysEx>(&payload);
-}
-
 std::optional<Event>
     convertMidi(const std::uint8_t* bytes, int size, int sampleOffset) noexcept
 {
@@ -241,11 +122,6 @@ std::uint8_t to7bit(float normalized) noexcept
     auto scaled = static_cast<int>(std::lround(normalized * 127.f));
     return static_cast<std::uint8_t>(std::clamp(scaled, 0, 127));
 }
-
-std::uint8_t statusByte(int status, int channel) noexcept
-{
-    return static_cast<std::uint8_t>(status | (channel & 0x0F));
-}
 } // namespace
 
 RawBytes toBytes(const Event& event) noexcept
@@ -261,19 +137,19 @@ RawBytes toBytes(const Event& event) noexcept
     event.visit(overloaded {
         [&](const NoteOn& n)
         {
-            push(statusByte(0x90, event.channel));
+            push(event.getStatus());
             push(static_cast<std::uint8_t>(n.pitch & 0x7F));
             push(to7bit(n.velocity));
         },
         [&](const NoteOff& n)
         {
-            push(statusByte(0x80, event.channel));
+            push(event.getStatus());
             push(static_cast<std::uint8_t>(n.pitch & 0x7F));
             push(to7bit(n.velocity));
         },
         [&](const ControlChange& cc)
         {
-            push(statusByte(0xB0, event.channel));
+            push(event.getStatus());
             push(static_cast<std::uint8_t>(cc.controller & 0x7F));
             push(to7bit(cc.value));
         },
@@ -283,24 +159,24 @@ RawBytes toBytes(const Event& event) noexcept
                 static_cast<int>(std::lround(pb.value * 8192.f)) + 8192,
                 0,
                 16383);
-            push(statusByte(0xE0, event.channel));
+            push(event.getStatus());
             push(static_cast<std::uint8_t>(raw & 0x7F));
             push(static_cast<std::uint8_t>((raw >> 7) & 0x7F));
         },
         [&](const ChannelAftertouch& at)
         {
-            push(statusByte(0xD0, event.channel));
+            push(event.getStatus());
             push(to7bit(at.pressure));
         },
         [&](const PolyAftertouch& pa)
         {
-            push(statusByte(0xA0, event.channel));
+            push(event.getStatus());
             push(static_cast<std::uint8_t>(pa.pitch & 0x7F));
             push(to7bit(pa.pressure));
         },
         [&](const ProgramChange& pc)
         {
-            push(statusByte(0xC0, event.channel));
+            push(event.getStatus());
             push(static_cast<std::uint8_t>(pc.program & 0x7F));
         },
         [&](const SysEx& sx)
@@ -319,10 +195,10 @@ std::string toString(const Event& event)
 
     auto renderChannel = [&]() -> std::string
     {
-        if (event.channel < 0)
+        if (event.getChannel() < 0)
             return {};
         char c[16];
-        std::snprintf(c, sizeof c, " ch=%d", event.channel);
+        std::snprintf(c, sizeof c, " ch=%d", event.getChannel());
         return c;
     };
 
@@ -3,10 +3,13 @@
 #include "../Common/Common.h"
 
 #include <array>
+#include <bit>
 #include <cstdint>
 #include <optional>
+#include <span>
 #include <string>
-#include <variant>
+#include <type_traits>
+#include <utility>
 
 namespace MakeASound::MIDI
 {
@@ -50,11 +53,14 @@ struct ProgramChange
     int program = 0; // 0..127
 };
 
-// Capped because the realtime stream only carries short control messages
-// (GM/GS/XG reset, MTC, master volume); longer dumps need a non-realtime path.
+// Capped at what one packed Event carries — six payload bytes, as in a UMP SysEx7
+// packet, plus the F0 / F7 around them. Enough for the short realtime control
+// messages (GM reset, master volume, device inquiry); longer ones go through a
+// SysExStream (MidiManager::setSysExArenaSize).
 struct SysEx
 {
-    static constexpr int maxBytes = 16;
+    static constexpr int maxPayloadBytes = 6;
+    static constexpr int maxBytes = maxPayloadBytes + 2;
 
     std::array<uint8_t, maxBytes> data {};
     int size = 0;
@@ -68,99 +74,293 @@ struct overloaded : Ts...
 template <class... Ts>
 overloaded(Ts...) -> overloaded<Ts...>;
 
+// Packed like a Universal MIDI Packet: a MIDI 1.0 status byte (kind and channel),
+// an index byte (pitch, controller or program) and one 32-bit data word, which holds
+// the normalised value's float bits so it round-trips exactly. With the offset that
+// is 12 bytes, trivially copyable, and every decoder below is constexpr; the typed
+// structs above are views built on demand, not what is stored.
 class Event
 {
 public:
     int sampleOffset = 0;
 
-    // 0..15 for voice/channel messages; -1 for SysEx and anything else
-    // where a MIDI channel is not meaningful.
-    int channel = 0;
-
-    static Event noteOn(int channel,
-                        int pitch,
-                        float velocity,
-                        int sampleOffset = 0) noexcept;
+    static constexpr Event noteOn(int channel,
+                                  int pitch,
+                                  float velocity,
+                                  int sampleOffset = 0) noexcept
+    {
+        return make(0x90, channel, pitch, velocity, sampleOffset);
+    }
 
-    static Event noteOff(int channel,
-                         int pitch,
-                         float velocity,
-                         int sampleOffset = 0) noexcept;
+    static constexpr Event noteOff(int channel,
+                                   int pitch,
+                                   float velocity,
+                                   int sampleOffset = 0) noexcept
+    {
+        return make(0x80, channel, pitch, velocity, sampleOffset);
+    }
 
-    static Event controlChange(int channel,
-                               int controller,
-                               float value,
-                               int sampleOffset = 0) noexcept;
+    static constexpr Event controlChange(int channel,
+                                         int controller,
+                                         float value,
+                                         int sampleOffset = 0) noexcept
+    {
+        return make(0xB0, channel, controller, value, sampleOffset);
+    }
 
-    static Event pitchBend(int channel, float value, int sampleOffset = 0) noexcept;
+    static constexpr Event
+        pitchBend(int channel, float value, int sampleOffset = 0) noexcept
+    {
+        return make(0xE0, channel, 0, value, sampleOffset);
+    }
 
-    static Event channelAftertouch(int channel,
-                                   float pressure,
-                                   int sampleOffset = 0) noexcept;
+    static constexpr Event channelAftertouch(int channel,
+                                             float pressure,
+                                             int sampleOffset = 0) noexcept
+    {
+        return make(0xD0, channel, 0, pressure, sampleOffset);
+    }
 
-    static Event polyAftertouch(int channel,
-                                int pitch,
-                                float pressure,
-                                int sampleOffset = 0) noexcept;
+    static constexpr Event polyAftertouch(int channel,
+                                          int pitch,
+                                          float pressure,
+                                          int sampleOffset = 0) noexcept
+    {
+        return make(0xA0, channel, pitch, pressure, sampleOffset);
+    }
 
-    static Event
-        programChange(int channel, int program, int sampleOffset = 0) noexcept;
+    static constexpr Event
+        programChange(int channel, int program, int sampleOffset = 0) noexcept
+    {
+        return make(0xC0, channel, program, 0.f, sampleOffset);
+    }
 
-    // Asserts in debug and yields an empty SysEx if `bytes` is null or
-    // `size` is out of [0, SysEx::maxBytes].
+    // `bytes` is a whole message, F0 to F7, or a bare payload. Asserts in debug and
+    // yields an empty SysEx if `bytes` is null or the payload is longer than
+    // SysEx::maxPayloadBytes.
     static Event
         sysEx(const uint8_t* bytes, int size, int sampleOffset = 0) noexcept;
 
-    bool isNoteOn() const noexcept;
-    bool isNoteOff() const noexcept;
-    bool isControlChange() const noexcept;
-    bool isPitchBend() const noexcept;
-    bool isChannelAftertouch() const noexcept;
-    bool isPolyAftertouch() const noexcept;
-    bool isProgramChange() const noexcept;
-    bool isSysEx() const noexcept;
-
-    // Null unless the event is of that kind (std::get_if semantics).
-    const NoteOn* asNoteOn() const noexcept;
-    const NoteOff* asNoteOff() const noexcept;
-    const ControlChange* asControlChange() const noexcept;
-    const PitchBend* asPitchBend() const noexcept;
-    const ChannelAftertouch* asChannelAftertouch() const noexcept;
-    const PolyAftertouch* asPolyAftertouch() const noexcept;
-    const ProgramChange* asProgramChange() const noexcept;
-    const SysEx* asSysEx() const noexcept;
+    // 0..15 for voice/channel messages; -1 for SysEx, where a MIDI channel is not
+    // meaningful.
+    constexpr int getChannel() const noexcept
+    {
+        return isSysEx() ? -1 : status & 0x0F;
+    }
+
+    // The MIDI 1.0 status byte; 0xF0 for SysEx.
+    constexpr std::uint8_t getStatus() const noexcept { return status; }
+
+    constexpr bool isNoteOn() const noexcept { return kind() == 0x90; }
+    constexpr bool isNoteOff() const noexcept { return kind() == 0x80; }
+    constexpr bool isControlChange() const noexcept { return kind() == 0xB0; }
+    constexpr bool isPitchBend() const noexcept { return kind() == 0xE0; }
+    constexpr bool isChannelAftertouch() const noexcept { return kind() == 0xD0; }
+    constexpr bool isPolyAftertouch() const noexcept { return kind() == 0xA0; }
+    constexpr bool isProgramChange() const noexcept { return kind() == 0xC0; }
+    constexpr bool isSysEx() const noexcept { return status == 0xF0; }
+
+    // Empty unless the event is of that kind.
+    constexpr std::optional<NoteOn> asNoteOn() const noexcept
+    {
+        return decodeIf<NoteOn>(isNoteOn());
+    }
+
+    constexpr std::optional<NoteOff> asNoteOff() const noexcept
+    {
+        return decodeIf<NoteOff>(isNoteOff());
+    }
+
+    constexpr std::optional<ControlChange> asControlChange() const noexcept
+    {
+        return decodeIf<ControlChange>(isControlChange());
+    }
+
+    constexpr std::optional<PitchBend> asPitchBend() const noexcept
+    {
+        return decodeIf<PitchBend>(isPitchBend());
+    }
+
+    constexpr std::optional<ChannelAftertouch> asChannelAftertouch() const noexcept
+    {
+        return decodeIf<ChannelAftertouch>(isChannelAftertouch());
+    }
+
+    constexpr std::optional<PolyAftertouch> asPolyAftertouch() const noexcept
+    {
+        return decodeIf<PolyAftertouch>(isPolyAftertouch());
+    }
+
+    constexpr std::optional<ProgramChange> asProgramChange() const noexcept
+    {
+        return decodeIf<ProgramChange>(isProgramChange());
+    }
 
+    constexpr std::optional<SysEx> asSysEx() const noexcept
+    {
+        return decodeIf<SysEx>(isSysEx());
+    }
+
+    // Calls `vis` with the decoded view, as std::visit would with the payload.
     template <class Visitor>
-    decltype(auto) visit(Visitor&& vis) const
+    constexpr decltype(auto) visit(Visitor&& vis) const
     {
-        return std::visit(std::forward<Visitor>(vis), payload);
+        switch (kind())
+        {
+            case 0x90:
+            {
+                const auto view = decode<NoteOn>();
+                return std::forward<Visitor>(vis)(view);
+            }
+            case 0x80:
+            {
+                const auto view = decode<NoteOff>();
+                return std::forward<Visitor>(vis)(view);
+            }
+            case 0xB0:
+            {
+                const auto view = decode<ControlChange>();
+                return std::forward<Visitor>(vis)(view);
+            }
+            case 0xE0:
+            {
+                const auto view = decode<PitchBend>();
+                return std::forward<Visitor>(vis)(view);
+            }
+            case 0xD0:
+            {
+                const auto view = decode<ChannelAftertouch>();
+                return std::forward<Visitor>(vis)(view);
+            }
+            case 0xA0:
+            {
+                const auto view = decode<PolyAftertouch>();
+                return std::forward<Visitor>(vis)(view);
+            }
+            case 0xC0:
+            {
+                const auto view = decode<ProgramChange>();
+                return std::forward<Visitor>(vis)(view);
+            }
+            default:
+            {
+                const auto view = decode<SysEx>();
+                return std::forward<Visitor>(vis)(view);
+            }
+        }
     }
 
-    bool operator<(const Event& other) const noexcept
+    constexpr bool operator<(const Event& other) const noexcept
     {
         return sampleOffset < other.sampleOffset;
     }
 
 private:
-    using Payload = std::variant<NoteOn,
-                                 NoteOff,
-                                 ControlChange,
-                                 PitchBend,
-                                 ChannelAftertouch,
-                                 PolyAftertouch,
-                                 ProgramChange,
-                                 SysEx>;
-
-    Payload payload = NoteOn {};
+    // For SysEx, `index` holds the payload length, with framedFlag set when the
+    // message came with its F0 / F7, and `extra` and `data` the payload itself.
+    static constexpr std::uint8_t framedFlag = 0x80;
+
+    static constexpr Event make(int kindToUse,
+                                int channel,
+                                int indexToUse,
+                                float value,
+                                int sampleOffsetToUse) noexcept
+    {
+        auto event = Event {};
+        event.sampleOffset = sampleOffsetToUse;
+        event.status = static_cast<std::uint8_t>(kindToUse | (channel & 0x0F));
+        event.index = static_cast<std::uint8_t>(indexToUse);
+        event.data = std::bit_cast<std::uint32_t>(value);
+        return event;
+    }
+
+    constexpr int kind() const noexcept
+    {
+        return isSysEx() ? 0xF0 : status & 0xF0;
+    }
+
+    constexpr float value() const noexcept { return std::bit_cast<float>(data); }
+
+    template <class T>
+    constexpr std::optional<T> decodeIf(bool matches) const noexcept
+    {
+        if (!matches)
+            return std::nullopt;
+
+        return decode<T>();
+    }
+
+    template <class T>
+    constexpr T decode() const noexcept
+    {
+        if constexpr (std::is_same_v<T, NoteOn> || std::is_same_v<T, NoteOff>)
+            return {.pitch = index, .velocity = value()};
+        else if constexpr (std::is_same_v<T, ControlChange>)
+            return {.controller = index, .value = value()};
+        else if constexpr (std::is_same_v<T, PitchBend>)
+            return {.value = value()};
+        else if constexpr (std::is_same_v<T, ChannelAftertouch>)
+            return {.pressure = value()};
+        else if constexpr (std::is_same_v<T, PolyAftertouch>)
+            return {.pitch = index, .pressure = value()};
+        else if constexpr (std::is_same_v<T, ProgramChange>)
+            return {.program = index};
+        else
+            return decodeSysEx();
+    }
+
+    constexpr SysEx decodeSysEx() const noexcept
+    {
+        auto sysEx = SysEx {};
+        auto framed = (index & framedFlag) != 0;
+        auto payloadSize = index & ~framedFlag;
+
+        auto push = [&](std::uint8_t byte)
+        { sysEx.data[static_cast<std::size_t>(sysEx.size++)] = byte; };
+
+        if (framed)
+            push(0xF0);
+
+        for (auto i = 0; i < payloadSize; ++i)
+            push(payloadByte(i));
+
+        if (framed)
+            push(0xF7);
+
+        return sysEx;
+    }
+
+    constexpr std::uint8_t payloadByte(int i) const noexcept
+    {
+        if (i < static_cast<int>(extra.size()))
+            return extra[static_cast<std::size_t>(i)];
+
+        return static_cast<std::uint8_t>(data >> (8 * (i - 2)));
+    }
+
+    std::uint8_t status = 0x90;
+    std::uint8_t index = 0;
+    std::array<std::uint8_t, 2> extra {};
+    std::uint32_t data = 0;
 };
 
+static_assert(sizeof(Event) == 12, "MIDI::Event should pack into 12 bytes");
+static_assert(std::is_trivially_copyable_v<Event>);
+
 struct Buffer : Vector<Event>
 {
     void addFrom(const Buffer& other) noexcept;
 
     // Stable (ties keep insertion order, so a note-off still precedes a
     // note-on at the same offset) and allocation-free: audio-thread safe.
+    // Insertion sort: linear on nearly sorted input, quadratic at worst.
     void sortByOffset() noexcept;
+
+    // As above, merging the buffer's sorted runs through `scratch` — several
+    // sources appended one after another sort in O(N log sources), anything in
+    // O(N log N). Falls back to the overload above when `scratch` holds fewer
+    // than size() events.
+    void sortByOffset(std::span<Event> scratch) noexcept;
 };
 
 // nullopt for messages that don't map (SysEx, MTC, song-position, undersized
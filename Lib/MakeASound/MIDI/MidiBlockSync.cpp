@@ -1,5 +1,6 @@
 #include "MidiBlockSync.h"
 #include "MidiManager.h"
+#include "../Common/Algorithms.h"
 
 #include <algorithm>
 #include <chrono>
@@ -8,44 +9,59 @@ namespace MakeASound
 {
 
 void MidiBlockSync::drainForBlock(MidiManager& midi, int numSamples, int sampleRate)
+{
+    drainForBlock(midi, numSamples, sampleRate, countedStreamTime);
+}
+
+void MidiBlockSync::drainForBlock(MidiManager& midi,
+                                  int numSamples,
+                                  int sampleRate,
+                                  double streamTime)
 {
     buffer.clear();
 
     if (numSamples <= 0 || sampleRate <= 0)
         return;
 
-    auto now = std::chrono::steady_clock::now();
-    midi.drainMessages(buffer);
+    auto rate = static_cast<double>(sampleRate);
+    auto blockLength = numSamples / rate;
 
-    if (!hasPrevBlock)
-    {
-        prevBlockStart = now;
-        hasPrevBlock = true;
+    clock.add(streamTime, toSeconds(std::chrono::steady_clock::now()));
+    countedStreamTime = streamTime + blockLength;
 
-        for (auto& evt: buffer)
-            evt.event.sampleOffset = 0;
+    // The stretch of stream time whose arrivals play in this block. Only what
+    // arrived before its end, by the fitted clock, is taken.
+    auto delay = latency >= 0 ? latency : numSamples;
+    auto windowStart = streamTime - delay / rate;
+    auto windowEnd = windowStart + blockLength;
 
-        return;
-    }
+    midi.drainMessages(buffer, fromSeconds(clock.map(windowEnd)));
 
     auto maxOffset = numSamples - 1;
-    auto rate = static_cast<double>(sampleRate);
 
     for (auto& evt: buffer)
     {
-        auto delta =
-            std::chrono::duration<double>(evt.arrival - prevBlockStart).count();
-        auto offset = static_cast<int>(delta * rate);
-        evt.event.sampleOffset = std::clamp(offset, 0, maxOffset);
+        auto position = (clock.unmap(toSeconds(evt.arrival)) - windowStart) * rate;
+        auto clamped = std::clamp(position, 0.0, static_cast<double>(maxOffset));
+        evt.event.sampleOffset = static_cast<int>(clamped);
     }
 
-    prevBlockStart = now;
+    // Drained a port at a time, each port in arrival order: one sorted run per port,
+    // which the merge sort joins in log2(ports) passes however many events each
+    // brought. The buffer stops at its capacity, which the scratch matches.
+    auto byOffset = [](const MidiInputEvent& a, const MidiInputEvent& b) noexcept
+    { return a.event.sampleOffset < b.event.sampleOffset; };
+
+    if (buffer.size() <= static_cast<int>(scratch.size()))
+        Algorithms::stableRunMergeSort(buffer.raw(), scratch, byOffset);
+    else
+        Algorithms::stableInsertionSort(buffer.raw(), byOffset);
 }
 
 void MidiBlockSync::reset() noexcept
 {
     buffer.clear();
-    hasPrevBlock = false;
+    clock.reset();
 }
 
 } // namespace MakeASound
@@ -1,24 +1,47 @@
 #pragma once
 
+#include "ClockSync.h"
 #include "MidiInfo.h"
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 namespace MakeASound
 {
 
 class MidiManager;
 
 // Resolves queued arrival times into sample offsets in the current block.
-// Needs queue-mode inputs (MidiManager::openInput without a callback). Maps
-// [prevBlockStart, now) onto [0, numSamples), so events land one block late —
-// the only way to keep offsets non-negative when MIDI arrives on its own thread.
+// Needs queue-mode inputs (MidiManager::openInput without a callback). Every block
+// pairs the device's stream time with steady_clock read on the audio thread, and a
+// LinearClockFit through those pairs maps arrival times onto the device's sample
+// clock, with the callback's scheduling jitter and the two clocks' drift fitted out.
+//
+// An event plays a fixed latency after it arrived: one block by default, the least
+// that keeps every offset in range however late in its period a callback runs.
+// setLatency() can go lower, trading that for events arriving too late for their
+// place clamped to offset 0. Events due after the block stay queued for the next.
+// events() comes back sorted by offset, ports merged; ties keep arrival order.
 class MidiBlockSync
 {
 public:
-    // Call once per audio callback; each call advances the window.
+    // Call once per audio callback; each call advances the window. streamTime is
+    // the block's start by the device's clock, AudioCallbackInfo::streamTime.
+    void drainForBlock(MidiManager& midi,
+                       int numSamples,
+                       int sampleRate,
+                       double streamTime);
+
+    // For a host without a stream clock: counts one from the blocks it's given.
     void drainForBlock(MidiManager& midi, int numSamples, int sampleRate);
 
+    // Samples from an event's arrival to its playback. Negative, the default, is
+    // one block, whatever size each block is.
+    void setLatency(int samples) noexcept { latency = samples; }
+
     // Call after a stream restart, xrun or config change — any gap that
-    // invalidates the previous window.
+    // invalidates the fitted clock.
     void reset() noexcept;
 
     const MidiEvents& events() const noexcept { return buffer; }
@@ -26,8 +49,83 @@ public:
 
 private:
     MidiEvents buffer;
-    MidiTimePoint prevBlockStart {};
-    bool hasPrevBlock {false};
+
+    // Room for a full buffer, so the per-block sort never allocates.
+    std::vector<MidiInputEvent> scratch =
+        std::vector<MidiInputEvent>(static_cast<std::size_t>(buffer.getCapacity()));
+
+    // Stream time in, steady_clock seconds out.
+    LinearClockFit clock;
+    double countedStreamTime {0.0};
+    int latency {-1};
 };
 
+namespace Detail
+{
+inline const MIDI::Event& getMidiEvent(const MIDI::Event& event) noexcept
+{
+    return event;
+}
+
+inline const MIDI::Event& getMidiEvent(const MidiInputEvent& event) noexcept
+{
+    return event.event;
+}
+} // namespace Detail
+
+// Renders one block of numSamples in slices cut at its events' sample offsets:
+// render(startSample, endSample) for each slice, in order, and onEvent(event)
+// between them, so an event takes effect from its own sample on. events must be
+// sorted by offset — MIDI::Buffer::sortByOffset, or MidiBlockSync's as they come;
+// one out of order or out of range applies at the nearest point still ahead.
+//
+// minSubBlockSize trades timing for slice count: a cut closer than that to the
+// previous one isn't made, and the event applies early, at the previous cut. So a
+// dense controller stream costs at most numSamples / minSubBlockSize + 1 slices,
+// every slice but the last is at least that long, and no event moves by as much.
+// 1 cuts at every distinct offset. Allocation-free, so it runs on the audio thread.
+template <typename Events, typename RenderFn, typename EventFn>
+void processBlockWithMidi(const Events& events,
+                          int numSamples,
+                          int minSubBlockSize,
+                          RenderFn&& render,
+                          EventFn&& onEvent)
+{
+    auto minSlice = std::max(1, minSubBlockSize);
+    auto end = std::max(0, numSamples);
+    auto cursor = 0;
+
+    for (const auto& item: events)
+    {
+        const auto& event = Detail::getMidiEvent(item);
+        auto offset = std::clamp(event.sampleOffset, cursor, end);
+
+        if (offset - cursor >= minSlice)
+        {
+            render(cursor, offset);
+            cursor = offset;
+        }
+
+        onEvent(event);
+    }
+
+    if (cursor < end)
+        render(cursor, end);
+}
+
+// The common case: the events MidiBlockSync resolved for this block.
+template <typename RenderFn, typename EventFn>
+void processBlockWithMidi(const MidiBlockSync& sync,
+                          int numSamples,
+                          int minSubBlockSize,
+                          RenderFn&& render,
+                          EventFn&& onEvent)
+{
+    processBlockWithMidi(sync.events(),
+                         numSamples,
+                         minSubBlockSize,
+                         std::forward<RenderFn>(render),
+                         std::forward<EventFn>(onEvent));
+}
+
 } // namespace MakeASound
@@ -7,6 +7,7 @@
 #include <chrono>
 #include <cstdint>
 #include <functional>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -37,8 +38,9 @@ struct MidiInputEvent
     int portId {};
     MIDI::Event event;
 
-    // Stamped when RtMidi delivered the message; MidiBlockSync translates
-    // it into event.sampleOffset.
+    // When the message came in: RtMidi's delivery time with its scheduling jitter
+    // taken out by the port's ArrivalDejitter. MidiBlockSync translates it into
+    // event.sampleOffset.
     MidiTimePoint arrival {};
 };
 
@@ -48,12 +50,21 @@ public:
     static constexpr int defaultCapacity = 1024;
 
     MidiEvents() { events.reserve(defaultCapacity); }
-    explicit MidiEvents(int capacity) { events.reserve(capacity); }
+    explicit MidiEvents(int capacityToUse)
+        : capacity(capacityToUse)
+    {
+        events.reserve(capacity);
+    }
 
     void clear() noexcept { events.clear(); }
     bool empty() const noexcept { return events.empty(); }
     int size() const noexcept { return events.size(); }
 
+    // What was reserved up front. Adding past it allocates, so a realtime filler
+    // stops at isFull() and leaves the rest for next time.
+    int getCapacity() const noexcept { return capacity; }
+    bool isFull() const noexcept { return events.size() >= capacity; }
+
     auto begin() noexcept { return events.begin(); }
     auto end() noexcept { return events.end(); }
     auto begin() const noexcept { return events.begin(); }
@@ -66,11 +77,24 @@ public:
     const Vector<MidiInputEvent>& raw() const noexcept { return events; }
 
 private:
+    int capacity = defaultCapacity;
     Vector<MidiInputEvent> events;
 };
 
 using MidiInputCallback = std::function<void(const MidiMessage&)>;
 
+// The bytes as RtMidi delivered them, borrowed for the call, and its timestamp as
+// in MidiMessage. Nothing is copied, so nothing allocates per message: the one to
+// use for dense streams - MPE, 14-bit controller floods - where building a
+// MidiMessage each time would churn the allocator on RtMidi's thread.
+// MIDI::convertMidi decodes them without allocating either.
+using MidiRawInputCallback =
+    std::function<void(std::span<const std::uint8_t> bytes, double timestamp)>;
+
+// One completed SysEx message, F0 to F7, borrowed for the call.
+using SysExCallback =
+    std::function<void(int portId, std::span<const std::uint8_t> message)>;
+
 // Decoded status, data bytes and a hex dump; channel is rendered 1-based.
 std::string formatMessage(const MidiMessage& message);
 
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "MidiInfo.h"
+#include "../Realtime/DropCounter.h"
+#include "../Realtime/SPSCQueue.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace MakeASound
+{
+
+// One input port's events on their way from the thread MIDI arrives on to the audio
+// thread. push() and drainInto() are wait-free, so neither end can make the other
+// skip a block, and nothing allocates when a burst arrives. Full drops the event and
+// counts it.
+//
+// One thread pushes, one drains.
+class MidiInputQueue
+{
+public:
+    // Over a second of a dense controller stream at typical block rates, for one
+    // block's drain to fall behind.
+    static constexpr std::size_t capacity = 1024;
+
+    // Pushing thread. Returns false, and counts the event as dropped, when full.
+    bool push(const MidiInputEvent& event) noexcept
+    {
+        if (queue.push(event))
+            return true;
+
+        dropped.count();
+        return false;
+    }
+
+    // Draining thread. Appends queued events to `out` in arrival order, stopping at
+    // the first one past `until` or when `out` is full; what it stops at stays
+    // queued for the next call. Returns how many it took.
+    int drainInto(MidiEvents& out, MidiTimePoint until) noexcept
+    {
+        // Read in place and released in one go: one acquire and one release,
+        // however many events a burst left.
+        auto region = queue.readAvailable();
+        auto taken = std::size_t {0};
+
+        for (auto run: {region.first, region.second})
+        {
+            for (const auto& event: run)
+            {
+                if (out.isFull() || event.arrival > until)
+                {
+                    queue.commitRead(taken);
+                    return static_cast<int>(taken);
+                }
+
+                out.raw().add(event);
+                ++taken;
+            }
+        }
+
+        queue.commitRead(taken);
+        return static_cast<int>(taken);
+    }
+
+    // Any thread. Events push() refused since construction.
+    std::uint64_t getDropped() const noexcept
+    {
+        return dropped.get();
+    }
+
+private:
+    SPSCQueue<MidiInputEvent, capacity> queue;
+    DropCounter dropped;
+};
+
+// Drains a set of MidiInputQueues into one MidiEvents, every queue every time; only
+// a full `out` stops early. Each call starts one queue further along than the last,
+// so when it does stop early, the same queues aren't always the ones kept waiting.
+//
+// Draining thread only.
+class MidiInputRotation
+{
+public:
+    // `queueAt(i)` gives the i-th of `numQueues` queues as a MidiInputQueue*, or
+    // nullptr for one that isn't drained. Returns how many events were taken.
+    template <typename QueueAt>
+    int drain(int numQueues,
+              QueueAt&& queueAt,
+              MidiEvents& out,
+              MidiTimePoint until) noexcept
+    {
+        auto taken = 0;
+
+        for (auto i = 0; i < numQueues && !out.isFull(); ++i)
+            if (MidiInputQueue* queue = queueAt((start + i) % numQueues))
+                taken += queue->drainInto(out, until);
+
+        if (numQueues > 0)
+            start = (start + 1) % numQueues;
+
+        return taken;
+    }
+
+private:
+    int start = 0;
+};
+
+} // namespace MakeASound
@@ -27,7 +27,7 @@ Vector<MidiPortInfo> MidiManager::getOutputPorts() const
 
 void MidiManager::openInput(int portId)
 {
-    pimpl->openInput(portId, nullptr);
+    pimpl->openInput(portId, MidiInputCallback {});
 }
 
 void MidiManager::openInput(int portId, const MidiInputCallback& cb)
@@ -35,9 +35,14 @@ void MidiManager::openInput(int portId, const MidiInputCallback& cb)
     pimpl->openInput(portId, cb);
 }
 
+void MidiManager::openInput(int portId, const MidiRawInputCallback& cb)
+{
+    pimpl->openInput(portId, cb);
+}
+
 int MidiManager::openVirtualInput(const std::string& name)
 {
-    return pimpl->openVirtualInput(name, nullptr);
+    return pimpl->openVirtualInput(name, MidiInputCallback {});
 }
 
 int MidiManager::openVirtualInput(const std::string& name,
@@ -46,6 +51,12 @@ int MidiManager::openVirtualInput(const std::string& name,
     return pimpl->openVirtualInput(name, cb);
 }
 
+int MidiManager::openVirtualInput(const std::string& name,
+                                  const MidiRawInputCallback& cb)
+{
+    return pimpl->openVirtualInput(name, cb);
+}
+
 void MidiManager::closeInput(int portId)
 {
     pimpl->closeInput(portId);
@@ -68,7 +79,32 @@ Vector<int> MidiManager::getOpenInputPorts() const
 
 void MidiManager::drainMessages(MidiEvents& out)
 {
-    pimpl->drainMessages(out.raw());
+    pimpl->drainMessages(out, MidiTimePoint::max());
+}
+
+void MidiManager::drainMessages(MidiEvents& out, MidiTimePoint until)
+{
+    pimpl->drainMessages(out, until);
+}
+
+std::uint64_t MidiManager::getNumDroppedEvents(int portId) const
+{
+    return pimpl->getNumDroppedEvents(portId);
+}
+
+void MidiManager::setSysExArenaSize(std::size_t bytes)
+{
+    pimpl->setSysExArenaSize(bytes);
+}
+
+int MidiManager::drainSysEx(const SysExCallback& deliver)
+{
+    return pimpl->drainSysEx(deliver);
+}
+
+std::uint64_t MidiManager::getNumDroppedSysEx(int portId) const
+{
+    return pimpl->getNumDroppedSysEx(portId);
 }
 
 void MidiManager::openOutput(int portId)
@@ -25,21 +25,50 @@ public:
     // Callback mode: `cb` fires on RtMidi's input thread, nothing is queued.
     void openInput(int portId, const MidiInputCallback& cb);
 
+    // Callback mode without a MidiMessage: `cb` borrows RtMidi's bytes, so
+    // nothing is allocated per message.
+    void openInput(int portId, const MidiRawInputCallback& cb);
+
     // Returns a synthetic (negative) portId, usable like a real one.
     // Virtual ports exist only on CoreMIDI / ALSA / JACK — throws on Windows.
     int openVirtualInput(const std::string& name);
     int openVirtualInput(const std::string& name,
                          const MidiInputCallback& cb);
+    int openVirtualInput(const std::string& name,
+                         const MidiRawInputCallback& cb);
 
     void closeInput(int portId);
     void closeAllInputs();
     bool isInputOpen(int portId) const;
     Vector<int> getOpenInputPorts() const;
 
-    // Audio-callback safe: `out` is pre-reserved so no allocation happens,
-    // and ports whose spinlock is contended are skipped until the next call.
+    // Audio-callback safe: each port's queue is wait-free, and `out` is
+    // pre-reserved so nothing allocates. No port is ever skipped; only a full
+    // `out` stops the drain, and what it leaves waits for the next call.
     void drainMessages(MidiEvents& out);
 
+    // Leaves queued every event that arrived after `until`, for a later call; each
+    // port stops at its first one.
+    void drainMessages(MidiEvents& out, MidiTimePoint until);
+
+    // Queue-mode events lost on this port because its queue was full — the audio
+    // thread drained too slowly for a burst. 0 for a port that isn't open.
+    std::uint64_t getNumDroppedEvents(int portId) const;
+
+    // SysEx longer than a MIDI::Event carries — sample dumps, firmware — is ignored
+    // unless this is set: queue-mode inputs opened after it get an arena of this
+    // many bytes, and their SysEx goes there whole instead of into the event queue.
+    // 0, the default, leaves SysEx filtered out at RtMidi.
+    void setSysExArenaSize(std::size_t bytes);
+
+    // Calls `deliver` for each SysEx message completed since the last call, every
+    // port in turn, and returns how many. Not for the audio thread: call it from
+    // the one that opens and closes inputs.
+    int drainSysEx(const SysExCallback& deliver);
+
+    // Messages lost on this port: too long for its arena, or the arena full.
+    std::uint64_t getNumDroppedSysEx(int portId) const;
+
     void openOutput(int portId);
 
     // Replaces any currently open output. Throws on Windows.
@@ -48,6 +77,8 @@ public:
     void closeOutput();
     bool isOutputOpen() const;
 
+    // Sends at once, on the calling thread. Any thread but the audio thread, which
+    // schedules through a MidiOutputScheduler instead.
     void sendMessage(const MidiMessage& message);
     void sendMessage(const std::uint8_t* bytes, std::size_t size);
 
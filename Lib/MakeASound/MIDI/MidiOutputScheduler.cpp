@@ -0,0 +1,128 @@
+#include "MidiOutputScheduler.h"
+#include "MidiManager.h"
+#include "../Common/Algorithms.h"
+
+#include <algorithm>
+
+namespace MakeASound
+{
+
+MidiOutputScheduler::MidiOutputScheduler(MidiManager& midi)
+    : MidiOutputScheduler([&midi](const MIDI::Event& event)
+                          { midi.sendMessage(event); })
+{
+}
+
+MidiOutputScheduler::MidiOutputScheduler(SendFn sendToUse)
+    : send(std::move(sendToUse))
+{
+    pending.reserve(queueCapacity * 2);
+    scratch.resize(queueCapacity * 2);
+
+    sender = std::thread([this] { run(); });
+}
+
+MidiOutputScheduler::~MidiOutputScheduler()
+{
+    {
+        auto lock = std::lock_guard(senderMutex);
+        senderQuit = true;
+    }
+
+    senderCv.notify_all();
+
+    if (sender.joinable())
+        sender.join();
+}
+
+void MidiOutputScheduler::beginBlock(int sampleRate, double streamTime) noexcept
+{
+    if (sampleRate <= 0)
+        return;
+
+    rate = static_cast<double>(sampleRate);
+    blockStart = streamTime;
+    clock.add(streamTime, toSeconds(std::chrono::steady_clock::now()));
+}
+
+bool MidiOutputScheduler::schedule(const MIDI::Event& event) noexcept
+{
+    if (clock.empty())
+    {
+        dropped.count();
+        return false;
+    }
+
+    auto samples = static_cast<double>(std::max(0, event.sampleOffset) + latency);
+    auto due = fromSeconds(clock.map(blockStart + samples / rate));
+
+    if (queue.push({due, event}))
+        return true;
+
+    dropped.count();
+    return false;
+}
+
+void MidiOutputScheduler::reset() noexcept
+{
+    clock.reset();
+}
+
+void MidiOutputScheduler::run()
+{
+    auto lock = std::unique_lock(senderMutex);
+
+    while (!senderQuit)
+    {
+        lock.unlock();
+
+        collect();
+        sendDue();
+
+        auto wake = std::chrono::steady_clock::now() + pollInterval;
+
+        if (!pending.empty())
+            wake = std::min(wake, pending.front().due);
+
+        lock.lock();
+        senderCv.wait_until(lock, wake, [this] { return senderQuit; });
+    }
+}
+
+void MidiOutputScheduler::collect()
+{
+    auto item = Scheduled {};
+    auto added = false;
+
+    // Room for a full queue on top of a full one waiting - what scratch is sized
+    // for: a sender that falls that far behind leaves the rest queued, and the audio
+    // thread sees drops.
+    while (pending.size() < queueCapacity * 2 && queue.pop(item))
+    {
+        pending.push_back(item);
+        added = true;
+    }
+
+    // What was pending is sorted, and each block's events usually are: a few runs
+    // for the merge sort, however many events.
+    if (added)
+        Algorithms::stableRunMergeSort(pending,
+                                       scratch,
+                                       [](const Scheduled& a, const Scheduled& b)
+                                       { return a.due < b.due; });
+}
+
+void MidiOutputScheduler::sendDue()
+{
+    auto now = std::chrono::steady_clock::now();
+    auto end = std::find_if(pending.begin(),
+                            pending.end(),
+                            [now](const Scheduled& s) { return s.due > now; });
+
+    for (auto it = pending.begin(); it != end; ++it)
+        send(it->event);
+
+    pending.erase(pending.begin(), end);
+}
+
+} // namespace MakeASound
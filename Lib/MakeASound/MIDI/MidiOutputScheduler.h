@@ -0,0 +1,103 @@
+#pragma once
+
+#include "ClockSync.h"
+#include "MidiInfo.h"
+#include "../Realtime/DropCounter.h"
+#include "../Realtime/PaddedSPSCQueue.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace MakeASound
+{
+
+class MidiManager;
+
+// Timed MIDI out from the audio thread. The audio callback schedules events at
+// sample offsets in its block; schedule() turns each into a steady_clock time
+// through the same stream-clock fit MidiBlockSync uses, and a sender thread sends it
+// when that time comes. Sending goes through RtMidi, which may lock or allocate, so
+// it never runs on the audio thread: scheduling is a little arithmetic and a
+// wait-free push of a few bytes.
+//
+// Events are sent in time order, ties in scheduling order; ones already due when
+// the sender gets to them go at once, in one batch. The sender sleeps until the next
+// one is due, waking at least every pollInterval to pick up new ones, so that is
+// also the most an event scheduled for "now" waits.
+class MidiOutputScheduler
+{
+public:
+    using SendFn = std::function<void(const MIDI::Event&)>;
+
+    static constexpr std::size_t queueCapacity = 1024;
+    static constexpr auto pollInterval = std::chrono::milliseconds(1);
+
+    // Sends to midi's output, which has to outlive the scheduler.
+    explicit MidiOutputScheduler(MidiManager& midi);
+
+    // Sends through `send`, called on the sender thread only.
+    explicit MidiOutputScheduler(SendFn send);
+
+    // Stops the sender; whatever hasn't been sent yet is dropped.
+    ~MidiOutputScheduler();
+
+    // Audio thread, once per block before any schedule(). streamTime is the block's
+    // start by the device's clock, AudioCallbackInfo::streamTime.
+    void beginBlock(int sampleRate, double streamTime) noexcept;
+
+    // Audio thread. Sends `event` at its sampleOffset in the current block, plus the
+    // latency. Returns false, and counts the event as dropped, when the queue is
+    // full or no block has begun.
+    bool schedule(const MIDI::Event& event) noexcept;
+
+    // Samples added to every event's time: the stream's output latency lines MIDI
+    // up with the audio rendered beside it. 0 by default.
+    void setLatency(int samples) noexcept { latency = samples; }
+
+    // Audio thread. Call after a stream restart, xrun or config change.
+    void reset() noexcept;
+
+    // Any thread. Events schedule() refused since construction.
+    std::uint64_t getDropped() const noexcept
+    {
+        return dropped.get();
+    }
+
+private:
+    struct Scheduled
+    {
+        MidiTimePoint due {};
+        MIDI::Event event;
+    };
+
+    void run();
+    void collect();
+    void sendDue();
+
+    SendFn send;
+
+    // Audio thread only.
+    LinearClockFit clock;
+    double rate {0.0};
+    double blockStart {0.0};
+    int latency {0};
+
+    PaddedSPSCQueue<Scheduled, queueCapacity> queue;
+    DropCounter dropped;
+
+    // Sender thread only: taken off the queue, sorted by due time.
+    std::vector<Scheduled> pending;
+    std::vector<Scheduled> scratch;
+
+    std::mutex senderMutex;
+    std::condition_variable senderCv;
+    bool senderQuit = false;
+    std::thread sender;
+};
+
+} // namespace MakeASound
@@ -0,0 +1,244 @@
+#pragma once
+
+#include "../Realtime/CacheLine.h"
+#include "../Realtime/DropCounter.h"
+#include "../Realtime/PaddedSPSCQueue.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <vector>
+
+namespace MakeASound
+{
+
+// SysEx of any length — sample dumps, firmware transfers, patch banks — from the
+// thread MIDI arrives on to one that handles it, for what MIDI::Event's six payload
+// bytes can't carry. feed() takes the bytes in whatever chunks they come in and
+// writes each message straight into a byte arena allocated up front; a completed one
+// is published through a queue of its own, and drain() hands it over as a span into
+// the arena, with no copy and no allocation at either end.
+//
+// Messages sit whole and contiguous in the arena, F0 to F7. One that would run past
+// the arena's end is moved to its start, once, when it gets there. One longer than
+// the arena, or arriving while the arena is still full of undrained ones, is dropped
+// and counted. Realtime bytes (F8-FF) in the middle of a message are skipped, as the
+// MIDI spec has them interleave; any other status byte abandons the message.
+//
+// One thread feeds, one drains.
+class SysExStream
+{
+public:
+    static constexpr std::size_t maxMessages = 256;
+
+    explicit SysExStream(std::size_t arenaBytes)
+        : arena(arenaBytes)
+    {
+    }
+
+    std::size_t getArenaSize() const noexcept { return arena.size(); }
+
+    // Feeding thread. Any chunk of the byte stream: a whole message, part of one,
+    // the end of one and the start of the next. Bytes outside a message are ignored.
+    void feed(std::span<const std::uint8_t> bytes) noexcept
+    {
+        auto size = bytes.size();
+
+        for (auto i = std::size_t {0}; i < size;)
+        {
+            auto byte = bytes[i];
+
+            // Data bytes go in as runs, one copy each: the bulk of a long message.
+            if (byte < 0x80)
+            {
+                auto end = dataRunEnd(bytes, i + 1);
+
+                if (inMessage)
+                    append(bytes.data() + i, end - i);
+
+                i = end;
+                continue;
+            }
+
+            if (byte == 0xF0)
+            {
+                if (inMessage)
+                    abandon();
+
+                begin();
+                append(&byte, 1);
+            }
+            else if (inMessage && byte == 0xF7)
+            {
+                append(&byte, 1);
+                finish();
+            }
+            else if (inMessage && byte < 0xF8)
+            {
+                abandon();
+            }
+
+            ++i;
+        }
+    }
+
+    // Draining thread. Calls deliver(std::span<const std::uint8_t>) for each
+    // completed message, in order, and returns how many. The span is only valid
+    // during the call: its bytes are handed back to the arena right after.
+    template <typename Fn>
+    int drain(Fn&& deliver)
+    {
+        auto count = 0;
+        auto message = Message {};
+
+        while (messages.pop(message))
+        {
+            auto start = static_cast<std::size_t>(message.start % arena.size());
+            deliver(
+                std::span<const std::uint8_t> {arena.data() + start, message.size});
+
+            reader.readPosition.store(message.start + message.size,
+                                      std::memory_order_release);
+            ++count;
+        }
+
+        return count;
+    }
+
+    // Any thread. Messages lost since construction: too long for the arena, or no
+    // room left for them.
+    std::uint64_t getDropped() const noexcept
+    {
+        return dropped.get();
+    }
+
+private:
+    // Positions run free, counting every byte the arena has held; a position's
+    // place in the arena is it modulo the arena's size.
+    struct Message
+    {
+        std::uint64_t start = 0;
+        std::size_t size = 0;
+    };
+
+    // The first status byte at or after `from`, or the end. Eight bytes at a time,
+    // which is most of what feeding a long dump costs.
+    static std::size_t dataRunEnd(std::span<const std::uint8_t> bytes,
+                                  std::size_t from) noexcept
+    {
+        constexpr auto highBits = std::uint64_t {0x8080808080808080};
+
+        auto size = bytes.size();
+
+        while (from + 8 <= size)
+        {
+            auto word = std::uint64_t {};
+            std::memcpy(&word, bytes.data() + from, sizeof(word));
+
+            if (word & highBits)
+                break;
+
+            from += 8;
+        }
+
+        while (from < size && bytes[from] < 0x80)
+            ++from;
+
+        return from;
+    }
+
+    void begin() noexcept
+    {
+        inMessage = true;
+        overflowed = false;
+        current = {writePosition, 0};
+    }
+
+    void append(const std::uint8_t* bytes, std::size_t count) noexcept
+    {
+        if (overflowed)
+            return;
+
+        auto size = arena.size();
+
+        if (current.size + count > size)
+        {
+            overflowed = true;
+            return;
+        }
+
+        // Would run past the end: move what there is to the arena's start.
+        auto offset = static_cast<std::size_t>(current.start % size);
+        auto wraps = offset + current.size + count > size;
+        auto start = wraps ? current.start + (size - offset) : current.start;
+
+        if (!hasRoom(start + current.size + count))
+        {
+            overflowed = true;
+            return;
+        }
+
+        if (wraps)
+        {
+            std::memmove(arena.data(), arena.data() + offset, current.size);
+            current.start = start;
+            offset = 0;
+        }
+
+        std::memcpy(arena.data() + offset + current.size, bytes, count);
+        current.size += count;
+    }
+
+    // Whether the arena is free up to `end`: the drain has released everything
+    // more than one arena's length before it.
+    bool hasRoom(std::uint64_t end) noexcept
+    {
+        if (end - cachedReadPosition <= arena.size())
+            return true;
+
+        // Acquire pairs with drain()'s release: the bytes it released are read.
+        cachedReadPosition = reader.readPosition.load(std::memory_order_acquire);
+        return end - cachedReadPosition <= arena.size();
+    }
+
+    void finish() noexcept
+    {
+        inMessage = false;
+
+        if (overflowed || !messages.push(current))
+        {
+            dropped.count();
+            return;
+        }
+
+        writePosition = current.start + current.size;
+    }
+
+    void abandon() noexcept
+    {
+        inMessage = false;
+        dropped.count();
+    }
+
+    std::vector<std::uint8_t> arena;
+    PaddedSPSCQueue<Message, maxMessages> messages;
+    DropCounter dropped;
+
+    // Feeding thread only.
+    Message current;
+    std::uint64_t writePosition = 0;
+    std::uint64_t cachedReadPosition = 0;
+    bool inMessage = false;
+    bool overflowed = false;
+
+    struct alignas(cacheLineSize) Reader
+    {
+        std::atomic<std::uint64_t> readPosition {0};
+    };
+
+    Reader reader;
+};
+
+} // namespace MakeASound
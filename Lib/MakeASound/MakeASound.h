@@ -2,10 +2,19 @@
 
 #include "Common/Common.h"
 #include "Realtime/SPSCQueue.h"
+#include "Realtime/PaddedSPSCQueue.h"
+#include "Realtime/AudioFifo.h"
+#include "Realtime/MPSCQueue.h"
+#include "Realtime/ParameterQueue.h"
+#include "Realtime/Outbox.h"
+#include "Realtime/HotSwapSlot.h"
+#include "Realtime/RealtimeScope.h"
 #include "Devices/DeviceManager.h"
 #include "Devices/DeviceQueries.h"
 #include "MIDI/MidiManager.h"
 #include "MIDI/MidiBlockSync.h"
+#include "MIDI/MidiOutputScheduler.h"
+#include "MIDI/SysExStream.h"
 #include "MIDI/MIDI.h"
 #include "UI/Dropdown.h"
 #include "UI/UIDeviceManager.h"
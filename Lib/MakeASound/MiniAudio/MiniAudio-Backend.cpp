@@ -1,5 +1,12 @@
 #include "MiniAudio-Backend.h"
 
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
 namespace MakeASound::MiniAudio
 {
 
@@ -142,9 +149,20 @@ ma_backend getMaBackend(Backend backend)
     }
 }
 
-Vector<Backend> probeAvailableBackends()
+Vector<Backend> probeAvailableBackends(std::chrono::milliseconds timeout)
 {
-    auto backends = Vector<Backend> {};
+    // Shared with the probe threads, so one that outlives the timeout still has
+    // somewhere to report to.
+    struct Probe
+    {
+        std::mutex mutex;
+        std::condition_variable done;
+        std::array<bool, MA_BACKEND_COUNT> cameUp {};
+        int remaining = 0;
+    };
+
+    auto probe = std::make_shared<Probe>();
+    auto candidates = Vector<ma_backend> {};
 
     for (auto i = 0; i < MA_BACKEND_COUNT; ++i)
     {
@@ -153,21 +171,72 @@ Vector<Backend> probeAvailableBackends()
         if (candidate == ma_backend_null || candidate == ma_backend_custom)
             continue;
 
-        if (!ma_is_backend_enabled(candidate))
-            continue;
+        if (ma_is_backend_enabled(candidate))
+            candidates.add(candidate);
+    }
 
-        auto probe = ma_context {};
+    probe->remaining = static_cast<int>(candidates.size());
 
-        if (ma_context_init(&candidate, 1, nullptr, &probe) != MA_SUCCESS)
-            continue;
+    for (auto candidate: candidates)
+    {
+        std::thread(
+            [probe, candidate]
+            {
+                auto backend = candidate;
+                auto context = ma_context {};
+                auto cameUp =
+                    ma_context_init(&backend, 1, nullptr, &context) == MA_SUCCESS;
+
+                if (cameUp)
+                    ma_context_uninit(&context);
 
-        ma_context_uninit(&probe);
-        backends.add(getBackend(candidate));
+                {
+                    auto lock = std::lock_guard(probe->mutex);
+                    probe->cameUp[static_cast<std::size_t>(candidate)] = cameUp;
+                    --probe->remaining;
+                }
+
+                probe->done.notify_all();
+            })
+            .detach();
     }
 
+    auto lock = std::unique_lock(probe->mutex);
+    probe->done.wait_for(lock, timeout, [&] { return probe->remaining == 0; });
+
+    auto backends = Vector<Backend> {};
+
+    for (auto i = 0; i < MA_BACKEND_COUNT; ++i)
+        if (probe->cameUp[static_cast<std::size_t>(i)])
+            backends.add(getBackend(static_cast<ma_backend>(i)));
+
     return backends;
 }
 
+int makeDeviceId(const ma_device_id& id, std::string_view name)
+{
+    // FNV-1a. The id is hashed whole, as ma_device_id_equal compares it: miniaudio
+    // zeroes it before the backend fills in its part.
+    auto hash = std::uint64_t {14695981039346656037ull};
+
+    auto mix = [&hash](const void* data, std::size_t size)
+    {
+        auto* bytes = static_cast<const unsigned char*>(data);
+
+        for (auto i = std::size_t {0}; i < size; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+    };
+
+    mix(&id, sizeof(id));
+    mix(name.data(), name.size());
+
+    auto folded = static_cast<int>((hash ^ (hash >> 32)) & 0x7FFFFFFF);
+    return folded != 0 ? folded : 1;
+}
+
 Vector<int> collectSampleRates(const ma_device_info& info)
 {
     static constexpr int standardRates[] = {
@@ -5,6 +5,9 @@
 #include "../Common/Common.h"
 #include "../Devices/DeviceInfo.h"
 
+#include <chrono>
+#include <string_view>
+
 namespace MakeASound::MiniAudio
 {
 
@@ -21,7 +24,19 @@ ma_backend getMaBackend(Backend backend);
 // Compiled-in is not enough — a build knows about WASAPI on a machine whose audio
 // service is down — so each candidate is initialised once and kept only if it comes
 // up. Null is left out: miniaudio's silent stand-in, not a driver to offer a user.
-Vector<Backend> probeAvailableBackends();
+//
+// Candidates are tried at once, each on a thread of its own, so the probe costs the
+// slowest of them rather than the sum. One that hasn't come up within `timeout` — a
+// hung PulseAudio or JACK server — is left out, and its thread left to finish on its
+// own. In miniaudio's priority order either way.
+Vector<Backend> probeAvailableBackends(std::chrono::milliseconds timeout);
+
+// From what the driver calls the device plus its name, not from where it falls in
+// the enumeration: a device keeps its id while others come and go, across an unplug
+// and replug that gives it back the same driver id, and from one run to the next.
+// Positive, so 0 stays free for "none"; two devices may collide, which the caller
+// resolves.
+int makeDeviceId(const ma_device_id& id, std::string_view name);
 
 // A native-format entry with sampleRate==0 means "any rate supported", in which
 // case the full set of standard rates is returned.
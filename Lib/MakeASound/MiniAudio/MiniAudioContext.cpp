@@ -0,0 +1,446 @@
+#include "MiniAudioContext.h"
+#include "../Devices/BackendCache.h"
+#include "../Devices/DeviceQueries.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <limits>
+
+namespace MakeASound::MiniAudio
+{
+
+namespace
+{
+// How stale the device list may get when nothing reports a change: a hot-plugged
+// device with no stream on it shows up within this, and the sample rate another app
+// moved a device to along with it.
+constexpr auto kDeviceListInterval = std::chrono::seconds(2);
+
+// How long a backend gets to come up when probed. A live server answers in
+// milliseconds; one that hasn't after this is treated as not there.
+constexpr auto kBackendProbeTimeout = std::chrono::seconds(2);
+
+// Everything a reader of getDevices() sees.
+bool sameDevice(const DeviceInfo& a, const DeviceInfo& b)
+{
+    return a.id == b.id && a.name == b.name && a.backend == b.backend
+           && a.outputChannels == b.outputChannels
+           && a.inputChannels == b.inputChannels
+           && a.duplexChannels == b.duplexChannels
+           && a.isDefaultOutput == b.isDefaultOutput
+           && a.isDefaultInput == b.isDefaultInput
+           && std::equal(a.sampleRates.begin(),
+                         a.sampleRates.end(),
+                         b.sampleRates.begin(),
+                         b.sampleRates.end())
+           && a.currentSampleRate == b.currentSampleRate
+           && a.preferredSampleRate == b.preferredSampleRate;
+}
+
+// Weak, so the registry never keeps a context alive on its own: the last manager
+// holding one decides when it goes.
+struct Registry
+{
+    std::mutex mutex;
+    std::unordered_map<Backend, std::weak_ptr<SharedContext>> contexts;
+    std::weak_ptr<BackendProbe> probe;
+};
+
+Registry& getRegistry()
+{
+    static auto registry = Registry {};
+    return registry;
+}
+
+// Versions count across every context, not per context: a manager switching backends
+// moves to another context's list, and must never land on the number it just had.
+std::atomic<std::uint64_t> lastVersion {0};
+} // namespace
+
+std::shared_ptr<SharedContext> SharedContext::acquire(Backend backendToUse)
+{
+    auto& registry = getRegistry();
+
+    // Held through a new context's init, so two managers asking at once share one
+    // connection rather than racing to make two.
+    auto lock = std::lock_guard(registry.mutex);
+    auto& slot = registry.contexts[backendToUse];
+
+    if (auto live = slot.lock())
+        return live;
+
+    auto created = std::shared_ptr<SharedContext>(new SharedContext(backendToUse));
+
+    if (created->isInitialised())
+        slot = created;
+
+    return created;
+}
+
+SharedContext::SharedContext(Backend backendToUse)
+{
+    auto requested = getMaBackend(backendToUse);
+    auto named = backendToUse != Backend::Unknown;
+
+    // A null list means miniaudio's own priority order; a list of exactly one fails
+    // rather than being quietly answered by the next backend down.
+    auto result = ma_context_init(named ? &requested : nullptr,
+                                  named ? 1 : 0,
+                                  nullptr,
+                                  &context);
+
+    // A backend that won't initialise leaves its managers alive but empty rather
+    // than taking down an application over a machine with no working audio.
+    if (result != MA_SUCCESS)
+    {
+        initError = getError(result);
+        return;
+    }
+
+    initialised = true;
+
+    // What answered, not what was asked for — the default order picks on its own.
+    backend = MiniAudio::getBackend(context.backend);
+
+    // The first list comes off the caller's thread, most likely before it asks.
+    enumerationRequested = true;
+    enumerationThread = std::thread([this] { runEnumeration(); });
+}
+
+SharedContext::~SharedContext()
+{
+    // Worker first: it enumerates the very context torn down below.
+    {
+        auto lock = std::lock_guard(enumerationMutex);
+        enumerationQuit = true;
+    }
+
+    enumerationCv.notify_all();
+
+    if (enumerationThread.joinable())
+        enumerationThread.join();
+
+    if (initialised)
+        ma_context_uninit(&context);
+}
+
+DeviceInfo SharedContext::buildDeviceInfo(const ma_device_info& enumInfo,
+                                          ma_device_type type)
+{
+    auto detailed = ma_device_info {};
+    auto result =
+        ma_context_get_device_info(&context, type, &enumInfo.id, &detailed);
+
+    auto& source = (result == MA_SUCCESS) ? detailed : enumInfo;
+
+    auto info = DeviceInfo {};
+    info.name = source.name;
+    info.backend = backend;
+
+    auto channels = 0;
+    for (auto i = 0u; i < source.nativeDataFormatCount; ++i)
+        channels = std::max(channels,
+                            static_cast<int>(source.nativeDataFormats[i].channels));
+
+    if (type == ma_device_type_playback)
+        info.outputChannels = channels;
+    else
+        info.inputChannels = channels;
+
+    info.sampleRates = collectSampleRates(source);
+    info.preferredSampleRate = pickPreferredSampleRate(info.sampleRates);
+
+    // miniaudio's device info only lists supported rates; only the platform knows
+    // which one is current, and the two differ the moment an app moves the device.
+    auto current = getCurrentSampleRate(info);
+    info.currentSampleRate = current > 0 ? current : info.preferredSampleRate;
+
+    if (type == ma_device_type_playback)
+        info.isDefaultOutput = enumInfo.isDefault != 0;
+    else
+        info.isDefaultInput = enumInfo.isDefault != 0;
+
+    return info;
+}
+
+int SharedContext::DeviceSnapshot::claimId(int preferred) const
+{
+    auto id = preferred;
+
+    while (byId.contains(id))
+        id = id == std::numeric_limits<int>::max() ? 1 : id + 1;
+
+    return id;
+}
+
+void SharedContext::DeviceSnapshot::addPlayback(const ma_device_id& driverId,
+                                                DeviceInfo info)
+{
+    auto entry = CachedDevice {};
+    entry.id = claimId(makeDeviceId(driverId, info.name));
+    entry.playbackId = driverId;
+    entry.hasPlayback = true;
+    entry.info = std::move(info);
+    entry.info.id = entry.id;
+
+    devices.add(std::move(entry));
+    index(devices.size() - 1);
+}
+
+void SharedContext::DeviceSnapshot::addCapture(const ma_device_id& driverId,
+                                               DeviceInfo info)
+{
+    // A playback device of the same name is the other half of the same hardware,
+    // and keeps its id: that is what a duplex config names. Two of one model pair
+    // up in order, first with first, rather than both inputs joining one output.
+    if (auto named = playbackByName.find(info.name); named != playbackByName.end())
+    {
+        for (auto position: named->second)
+        {
+            auto& cached = devices[position];
+
+            if (cached.hasCapture)
+                continue;
+
+            cached.captureId = driverId;
+            cached.hasCapture = true;
+
+            cached.info.inputChannels = info.inputChannels;
+            cached.info.isDefaultInput = info.isDefaultInput;
+            cached.info.duplexChannels =
+                std::min(cached.info.outputChannels, cached.info.inputChannels);
+
+            for (auto rate: info.sampleRates)
+                cached.info.sampleRates.addIfNotThere(rate);
+
+            cached.info.sampleRates.sort();
+            index(position);
+            return;
+        }
+    }
+
+    auto entry = CachedDevice {};
+    entry.id = claimId(makeDeviceId(driverId, info.name));
+    entry.captureId = driverId;
+    entry.hasCapture = true;
+    entry.info = std::move(info);
+    entry.info.id = entry.id;
+
+    devices.add(std::move(entry));
+    index(devices.size() - 1);
+}
+
+void SharedContext::DeviceSnapshot::index(std::size_t position)
+{
+    const auto& cached = devices[position];
+    byId.emplace(cached.id, position);
+
+    if (cached.hasPlayback)
+        playbackByName[cached.info.name].addIfNotThere(position);
+
+    if (cached.hasCapture)
+        captureByName[cached.info.name].addIfNotThere(position);
+}
+
+const SharedContext::CachedDevice*
+    SharedContext::DeviceSnapshot::findById(int id, bool input) const
+{
+    auto found = byId.find(id);
+
+    if (found == byId.end())
+        return nullptr;
+
+    const auto& cached = devices[found->second];
+    return (input ? cached.hasCapture : cached.hasPlayback) ? &cached : nullptr;
+}
+
+const SharedContext::CachedDevice*
+    SharedContext::DeviceSnapshot::findByName(const std::string& name,
+                                              bool input) const
+{
+    const auto& names = input ? captureByName : playbackByName;
+    auto found = names.find(name);
+
+    return found != names.end() ? &devices[found->second[0]] : nullptr;
+}
+
+Error SharedContext::refresh()
+{
+    auto lock = std::lock_guard(enumerateMutex);
+    auto next = DeviceSnapshot {};
+
+    // No answer publishes an empty list: ids from the last one may not survive
+    // whatever went wrong.
+    if (!initialised)
+    {
+        publishSnapshot(std::move(next));
+        return Error::SYSTEM_ERROR;
+    }
+
+    ma_device_info* playbackInfos = nullptr;
+    auto playbackCount = ma_uint32 {0};
+    ma_device_info* captureInfos = nullptr;
+    auto captureCount = ma_uint32 {0};
+
+    auto result = ma_context_get_devices(&context,
+                                         &playbackInfos,
+                                         &playbackCount,
+                                         &captureInfos,
+                                         &captureCount);
+
+    if (result != MA_SUCCESS)
+    {
+        publishSnapshot(std::move(next));
+        return getError(result);
+    }
+
+    next.devices.reserve(playbackCount + captureCount);
+
+    for (auto i = 0u; i < playbackCount; ++i)
+    {
+        const auto& source = playbackInfos[i];
+        next.addPlayback(source.id,
+                         buildDeviceInfo(source, ma_device_type_playback));
+    }
+
+    for (auto i = 0u; i < captureCount; ++i)
+    {
+        const auto& source = captureInfos[i];
+        next.addCapture(source.id, buildDeviceInfo(source, ma_device_type_capture));
+    }
+
+    publishSnapshot(std::move(next));
+    return Error::NoError;
+}
+
+void SharedContext::publishSnapshot(DeviceSnapshot next)
+{
+    // Only enumerations publish, and they hold enumerateMutex, so nothing can
+    // publish between this read and the store below.
+    auto current = SnapshotPtr {};
+
+    {
+        auto lock = std::lock_guard(snapshotMutex);
+        current = snapshot;
+    }
+
+    // Same devices, same ids, same everything a reader sees: keep the version, so a
+    // host polling it only rebuilds its UI when there is something new.
+    auto sameInfo = [](const CachedDevice& a, const CachedDevice& b)
+    { return sameDevice(a.info, b.info); };
+
+    if (current != nullptr
+        && std::equal(current->devices.begin(),
+                      current->devices.end(),
+                      next.devices.begin(),
+                      next.devices.end(),
+                      sameInfo))
+        return;
+
+    next.version = lastVersion.fetch_add(1, std::memory_order_relaxed) + 1;
+    auto published = std::make_shared<const DeviceSnapshot>(std::move(next));
+
+    auto lock = std::lock_guard(snapshotMutex);
+    snapshot = std::move(published);
+}
+
+SharedContext::SnapshotPtr SharedContext::load()
+{
+    {
+        auto lock = std::lock_guard(snapshotMutex);
+
+        if (snapshot != nullptr)
+            return snapshot;
+    }
+
+    refresh();
+
+    auto lock = std::lock_guard(snapshotMutex);
+    return snapshot;
+}
+
+std::uint64_t SharedContext::getVersion()
+{
+    auto lock = std::lock_guard(snapshotMutex);
+    return snapshot != nullptr ? snapshot->version : 0;
+}
+
+void SharedContext::requestEnumeration()
+{
+    {
+        auto lock = std::lock_guard(enumerationMutex);
+        enumerationRequested = true;
+    }
+
+    enumerationCv.notify_one();
+}
+
+void SharedContext::runEnumeration()
+{
+    auto lock = std::unique_lock(enumerationMutex);
+
+    while (true)
+    {
+        enumerationCv.wait_for(lock,
+                               kDeviceListInterval,
+                               [this]
+                               { return enumerationRequested || enumerationQuit; });
+
+        if (enumerationQuit)
+            return;
+
+        enumerationRequested = false;
+
+        lock.unlock();
+        refresh();
+        lock.lock();
+    }
+}
+
+std::shared_ptr<BackendProbe> BackendProbe::acquire()
+{
+    auto& registry = getRegistry();
+    auto lock = std::lock_guard(registry.mutex);
+
+    if (auto live = registry.probe.lock())
+        return live;
+
+    auto created = std::make_shared<BackendProbe>();
+
+    // The default order doesn't need the probe, so nothing waits for it here.
+    if (auto fromDisk = loadCachedBackends())
+    {
+        created->backends = std::move(*fromDisk);
+        created->cached = true;
+    }
+
+    std::thread([created] { created->run(); }).detach();
+
+    registry.probe = created;
+    return created;
+}
+
+Vector<Backend> BackendProbe::get()
+{
+    auto lock = std::unique_lock(mutex);
+    done.wait(lock, [this] { return probed || cached; });
+
+    return backends;
+}
+
+void BackendProbe::run()
+{
+    auto found = probeAvailableBackends(kBackendProbeTimeout);
+    saveCachedBackends(found);
+
+    {
+        auto lock = std::lock_guard(mutex);
+        backends = std::move(found);
+        probed = true;
+    }
+
+    done.notify_all();
+}
+
+} // namespace MakeASound::MiniAudio
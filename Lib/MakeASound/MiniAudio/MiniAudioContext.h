@@ -0,0 +1,157 @@
+#pragma once
+
+#include "MiniAudio-Backend.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+namespace MakeASound::MiniAudio
+{
+
+// One ma_context and the device list enumerated through it, shared by every
+// DeviceManager in the process that asked for the same backend: a second manager
+// costs neither another connection to the sound server nor another enumeration. Each
+// manager keeps its own ma_device. Reference-counted; the last manager to let go
+// tears the context down, and the next to ask brings up a fresh one.
+class SharedContext
+{
+public:
+    struct CachedDevice
+    {
+        int id {};
+        ma_device_id playbackId {};
+        ma_device_id captureId {};
+        bool hasPlayback = false;
+        bool hasCapture = false;
+        DeviceInfo info {};
+    };
+
+    // One enumeration, never modified once published. A reader holds on to its own
+    // for as long as it needs it — through a device open, say — whatever gets
+    // published in the meantime.
+    struct DeviceSnapshot
+    {
+        std::uint64_t version = 0;
+        Vector<CachedDevice> devices;
+
+        // Positions in devices, so an open or a re-point is a lookup, not a scan.
+        // Two of one model share a name, so a name lists every device with that
+        // side, in enumeration order.
+        std::unordered_map<int, std::size_t> byId;
+        std::unordered_map<std::string, Vector<std::size_t>> playbackByName;
+        std::unordered_map<std::string, Vector<std::size_t>> captureByName;
+
+        // `preferred`, or the next id up that no device here has yet, wrapping past
+        // the largest int to 1.
+        int claimId(int preferred) const;
+
+        // In enumeration order, playback first. A capture side joins the first
+        // playback device of its name that has none yet; failing that it is a
+        // device of its own. Either way `info.id` is overwritten with the one given.
+        void addPlayback(const ma_device_id& driverId, DeviceInfo info);
+        void addCapture(const ma_device_id& driverId, DeviceInfo info);
+
+        // Indexes devices[position] under its id and the sides it has.
+        void index(std::size_t position);
+
+        // The device with that id, or the first with that name, if it has the side
+        // asked for.
+        const CachedDevice* findById(int id, bool input) const;
+        const CachedDevice* findByName(const std::string& name, bool input) const;
+    };
+
+    using SnapshotPtr = std::shared_ptr<const DeviceSnapshot>;
+
+    // The live context for `backend`, or a new one. Backend::Unknown is miniaudio's
+    // default order, shared among everyone who asked for that rather than matched to
+    // whichever API it lands on. A context that fails to come up is handed out but
+    // not shared, so the next caller tries again.
+    static std::shared_ptr<SharedContext> acquire(Backend backend);
+
+    SharedContext(const SharedContext&) = delete;
+    SharedContext& operator=(const SharedContext&) = delete;
+    ~SharedContext();
+
+    bool isInitialised() const { return initialised; }
+    Error getInitError() const { return initError; }
+
+    // What answered, not what was asked for; Unknown if nothing did.
+    Backend getBackend() const { return backend; }
+
+    // For ma_device_init. Outlives any device opened on it as long as the opener
+    // holds its reference.
+    ma_context* get() { return &context; }
+
+    // Enumerates and publishes, unless the result matches what is already out. Not
+    // recorded as anyone's lastError: a worker calls this on a timer.
+    Error refresh();
+
+    // The current snapshot, enumerating first if there has never been one.
+    SnapshotPtr load();
+
+    // 0 before the first snapshot.
+    std::uint64_t getVersion();
+
+    // Asks the enumeration worker to look again now instead of at the next interval.
+    void requestEnumeration();
+
+private:
+    explicit SharedContext(Backend backendToUse);
+
+    DeviceInfo buildDeviceInfo(const ma_device_info& enumInfo, ma_device_type type);
+    void publishSnapshot(DeviceSnapshot next);
+
+    // Own thread: every OS notification asks for a re-enumeration, and the interval
+    // catches hot-plugs no open stream hears about.
+    void runEnumeration();
+
+    ma_context context {};
+    bool initialised = false;
+    Error initError = Error::NoError;
+    Backend backend = Backend::Unknown;
+
+    // Guards the pointer only, held for a copy of it: readers never wait on an
+    // enumeration, which builds its snapshot before taking this.
+    std::mutex snapshotMutex;
+    SnapshotPtr snapshot;
+
+    // Held across an enumeration: managers refreshing at once take turns, and the
+    // one publishing knows nothing else is.
+    std::mutex enumerateMutex;
+
+    std::thread enumerationThread;
+    std::mutex enumerationMutex;
+    std::condition_variable enumerationCv;
+    bool enumerationRequested = false;
+    bool enumerationQuit = false;
+};
+
+// The backend probe, shared the same way: started by the first manager constructed,
+// answered to every one alive while it runs and after. Its thread holds a reference
+// too and is left to finish on its own, so a manager torn down mid-probe doesn't
+// wait out a hung server's timeout.
+class BackendProbe
+{
+public:
+    static std::shared_ptr<BackendProbe> acquire();
+
+    // Until the probe is in, the last run's answer from the disk cache stands in;
+    // with no cache this waits for the probe, which is bounded by its timeout.
+    Vector<Backend> get();
+
+private:
+    void run();
+
+    std::mutex mutex;
+    std::condition_variable done;
+    Vector<Backend> backends;
+    bool probed = false;
+    bool cached = false;
+};
+
+} // namespace MakeASound::MiniAudio
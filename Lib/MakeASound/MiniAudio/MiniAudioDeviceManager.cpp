@@ -1,5 +1,6 @@
 #include "MiniAudioDeviceManager.h"
 #include "../Devices/DeviceQueries.h"
+#include "../Audio/Interleave.h"
 
 #include <algorithm>
 #include <chrono>
@@ -18,6 +19,50 @@ constexpr auto kRecoveryRetryInterval = std::chrono::milliseconds(250);
 constexpr auto kWatchdogInterval = std::chrono::milliseconds(250);
 constexpr auto kStarvationTimeoutMs = std::int64_t {1000};
 
+// Only for a backend that reports no period at all and was asked for none: the same
+// block size getDefaultConfig() asks for.
+constexpr auto kFallbackBlockSize = 512;
+
+// Everything but the slices: what ma_device_init was given, and what the open sized
+// the stream's buffers and callback path for.
+bool needsNewDevice(const StreamConfig& open, const StreamConfig& next)
+{
+    auto sameSide = [](const std::optional<StreamParameters>& a,
+                       const std::optional<StreamParameters>& b)
+    {
+        if (a.has_value() != b.has_value())
+            return false;
+
+        return !a.has_value() || a->device.id == b->device.id;
+    };
+
+    auto sameOptions = [](const std::optional<StreamOptions>& a,
+                          const std::optional<StreamOptions>& b)
+    {
+        if (a.has_value() != b.has_value())
+            return false;
+
+        if (!a.has_value())
+            return true;
+
+        const auto& x = a->flags;
+        const auto& y = b->flags;
+
+        return x.nonInterleaved == y.nonInterleaved
+               && x.minimizeLatency == y.minimizeLatency
+               && x.hogDevice == y.hogDevice
+               && x.skipOutputClear == y.skipOutputClear
+               && x.fixedBlockSize == y.fixedBlockSize
+               && a->numberOfBuffers == b->numberOfBuffers
+               && a->streamName == b->streamName && a->priority == b->priority;
+    };
+
+    return !sameSide(open.input, next.input) || !sameSide(open.output, next.output)
+           || open.sampleRate != next.sampleRate
+           || open.maxBlockSize != next.maxBlockSize
+           || !sameOptions(open.options, next.options);
+}
+
 std::int64_t nowMs()
 {
     const auto now = std::chrono::steady_clock::now().time_since_epoch();
@@ -80,85 +125,38 @@ ma_device_config makeDeviceConfig(const StreamConfig& streamConfig,
             config.playback.shareMode = ma_share_mode_exclusive;
             config.capture.shareMode = ma_share_mode_exclusive;
         }
+
+        // miniaudio's own pre-callback clear is the first of the passes the host has
+        // promised to make unnecessary.
+        if (options.flags.skipOutputClear)
+            config.noPreSilencedOutputBuffer = MA_TRUE;
     }
 
     return config;
 }
-
-void deinterleaveSlice(const float* src,
-                       float* dst,
-                       int srcChannels,
-                       int firstChannel,
-                       int count,
-                       int frames)
-{
-    for (auto frame = 0; frame < frames; ++frame)
-        for (auto ch = 0; ch < count; ++ch)
-            dst[ch * frames + frame] =
-                src[frame * srcChannels + (firstChannel + ch)];
-}
-
-void interleaveSlice(const float* src,
-                     float* dst,
-                     int dstChannels,
-                     int firstChannel,
-                     int count,
-                     int frames)
-{
-    for (auto frame = 0; frame < frames; ++frame)
-        for (auto ch = 0; ch < count; ++ch)
-            dst[frame * dstChannels + (firstChannel + ch)] =
-                src[ch * frames + frame];
-}
 } // namespace
 
 DeviceManager::DeviceManager()
+    : backendProbe(BackendProbe::acquire())
+    , shared(SharedContext::acquire(Backend::Unknown))
 {
-    initContext(Backend::Unknown);
+    setError(shared->getInitError());
 }
 
-Error DeviceManager::initContext(Backend backendToUse)
+std::shared_ptr<SharedContext> DeviceManager::getShared() const
 {
-    auto requested = getMaBackend(backendToUse);
-    auto named = backendToUse != Backend::Unknown;
-
-    // A null list means miniaudio's own priority order; a list of exactly one fails
-    // rather than being quietly answered by the next backend down.
-    auto result = ma_context_init(named ? &requested : nullptr,
-                                  named ? 1 : 0,
-                                  nullptr,
-                                  &context);
-
-    // A backend that won't initialise leaves the manager alive but empty rather than
-    // taking down an application over a machine with no working audio.
-    if (result != MA_SUCCESS)
-    {
-        currentBackend = Backend::Unknown;
-        return setError(getError(result));
-    }
-
-    contextInitialised = true;
-
-    // What answered, not what was asked for — the default order picks on its own.
-    currentBackend = MiniAudio::getBackend(context.backend);
-
-    return setError(Error::NoError);
+    auto lock = std::lock_guard(sharedMutex);
+    return shared;
 }
 
-const Vector<Backend>& DeviceManager::getAvailableBackends()
+Vector<Backend> DeviceManager::getAvailableBackends()
 {
-    if (!backendsProbed)
-    {
-        availableBackends = probeAvailableBackends();
-        backendsProbed = true;
-    }
-
-    return availableBackends;
+    return backendProbe->get();
 }
 
 Backend DeviceManager::getBackend() const
 {
-    return currentBackend;
+    return getShared()->getBackend();
 }
 
 Error DeviceManager::setBackend(Backend backendToUse)
@@ -170,23 +168,28 @@ Error DeviceManager::setBackend(Backend backendToUse)
     shouldRun = false;
     stopLocked();
 
-    // Ids are handed out per enumeration, and this one is going away: the next open
-    // would point at a device number that means something else on the new API.
-    deviceCache.clear();
     config = {};
+    requestedConfig = {};
+
+    // Another API is another route, whatever shape the next stream turns out to be.
+    openedShape = {};
+    ++generation;
+
+    // The device is gone, so nothing of ours still points into the old context; it
+    // goes when whoever else shares it lets go too.
+    auto next = SharedContext::acquire(backendToUse);
 
-    if (contextInitialised)
     {
-        ma_context_uninit(&context);
-        contextInitialised = false;
+        auto sharedLock = std::lock_guard(sharedMutex);
+        shared = next;
     }
 
-    return initContext(backendToUse);
+    return setError(next->getInitError());
 }
 
 DeviceManager::~DeviceManager()
 {
-    // Worker first: it re-opens the very device and context torn down below.
+    // Worker first: it re-opens the very device torn down below.
     {
         auto lock = std::lock_guard(recoveryMutex);
         recoveryQuit = true;
@@ -197,54 +200,8 @@ DeviceManager::~DeviceManager()
     if (recoveryThread.joinable())
         recoveryThread.join();
 
+    // Before the members drop the context reference: the device was opened on it.
     stop();
-
-    if (contextInitialised)
-    {
-        ma_context_uninit(&context);
-        contextInitialised = false;
-    }
-}
-
-DeviceInfo DeviceManager::buildDeviceInfo(const ma_device_info& enumInfo,
-                                          ma_device_type type,
-                                          int assignedId)
-{
-    auto detailed = ma_device_info {};
-    auto result =
-        ma_context_get_device_info(&context, type, &enumInfo.id, &detailed);
-
-    auto& source = (result == MA_SUCCESS) ? detailed : enumInfo;
-
-    auto info = DeviceInfo {};
-    info.id = assignedId;
-    info.name = source.name;
-    info.backend = currentBackend;
-
-    auto channels = 0;
-    for (auto i = 0u; i < source.nativeDataFormatCount; ++i)
-        channels = std::max(channels,
-                            static_cast<int>(source.nativeDataFormats[i].channels));
-
-    if (type == ma_device_type_playback)
-        info.outputChannels = channels;
-    else
-        info.inputChannels = channels;
-
-    info.sampleRates = collectSampleRates(source);
-    info.preferredSampleRate = pickPreferredSampleRate(info.sampleRates);
-
-    // miniaudio's device info only lists supported rates; only the platform knows
-    // which one is current, and the two differ the moment an app moves the device.
-    auto current = getCurrentSampleRate(info);
-    info.currentSampleRate = current > 0 ? current : info.preferredSampleRate;
-
-    if (type == ma_device_type_playback)
-        info.isDefaultOutput = enumInfo.isDefault != 0;
-    else
-        info.isDefaultInput = enumInfo.isDefault != 0;
-
-    return info;
 }
 
 Error DeviceManager::setError(Error error)
@@ -253,96 +210,14 @@ Error DeviceManager::setError(Error error)
     return error;
 }
 
-Error DeviceManager::refreshDeviceCache()
-{
-    deviceCache.clear();
-
-    if (!contextInitialised)
-        return setError(Error::SYSTEM_ERROR);
-
-    ma_device_info* playbackInfos = nullptr;
-    auto playbackCount = ma_uint32 {0};
-    ma_device_info* captureInfos = nullptr;
-    auto captureCount = ma_uint32 {0};
-
-    auto result = ma_context_get_devices(&context,
-                                         &playbackInfos,
-                                         &playbackCount,
-                                         &captureInfos,
-                                         &captureCount);
-
-    if (result != MA_SUCCESS)
-        return setError(getError(result));
-
-    auto nextId = 0;
-
-    for (auto i = 0u; i < playbackCount; ++i)
-    {
-        auto entry = CachedDevice {};
-        entry.id = nextId++;
-        entry.playbackId = playbackInfos[i].id;
-        entry.hasPlayback = true;
-        entry.info =
-            buildDeviceInfo(playbackInfos[i], ma_device_type_playback, entry.id);
-        deviceCache.add(std::move(entry));
-    }
-
-    for (auto i = 0u; i < captureCount; ++i)
-    {
-        auto matched = false;
-
-        for (auto& cached: deviceCache)
-        {
-            if (!cached.hasPlayback)
-                continue;
-
-            if (cached.info.name == captureInfos[i].name)
-            {
-                cached.captureId = captureInfos[i].id;
-                cached.hasCapture = true;
-
-                auto captureInfo =
-                    buildDeviceInfo(captureInfos[i], ma_device_type_capture, cached.id);
-
-                cached.info.inputChannels = captureInfo.inputChannels;
-                cached.info.isDefaultInput = captureInfo.isDefaultInput;
-                cached.info.duplexChannels = std::min(cached.info.outputChannels,
-                                                     cached.info.inputChannels);
-
-                for (auto rate: captureInfo.sampleRates)
-                    cached.info.sampleRates.addIfNotThere(rate);
-
-                cached.info.sampleRates.sort();
-                matched = true;
-                break;
-            }
-        }
-
-        if (!matched)
-        {
-            auto entry = CachedDevice {};
-            entry.id = nextId++;
-            entry.captureId = captureInfos[i].id;
-            entry.hasCapture = true;
-            entry.info =
-                buildDeviceInfo(captureInfos[i], ma_device_type_capture, entry.id);
-            deviceCache.add(std::move(entry));
-        }
-    }
-
-    return Error::NoError;
-}
-
 Vector<DeviceInfo> DeviceManager::getDevices()
 {
-    // Enumerating rebuilds the cache, which recovery reads while re-opening.
-    auto lock = std::lock_guard(deviceMutex);
-    refreshDeviceCache();
+    auto current = getShared()->load();
 
     auto result = Vector<DeviceInfo> {};
-    result.reserve(deviceCache.size());
+    result.reserve(current->devices.size());
 
-    for (const auto& cached: deviceCache)
+    for (const auto& cached: current->devices)
         result.add(cached.info);
 
     return result;
@@ -350,14 +225,13 @@ Vector<DeviceInfo> DeviceManager::getDevices()
 
 DeviceInfo DeviceManager::getDefaultInputDevice()
 {
-    auto lock = std::lock_guard(deviceMutex);
-    refreshDeviceCache();
+    auto current = getShared()->load();
 
-    for (const auto& cached: deviceCache)
+    for (const auto& cached: current->devices)
         if (cached.hasCapture && cached.info.isDefaultInput)
             return cached.info;
 
-    for (const auto& cached: deviceCache)
+    for (const auto& cached: current->devices)
         if (cached.hasCapture)
             return cached.info;
 
@@ -366,27 +240,27 @@ DeviceInfo DeviceManager::getDefaultInputDevice()
 
 DeviceInfo DeviceManager::getDefaultOutputDevice()
 {
-    auto lock = std::lock_guard(deviceMutex);
-    refreshDeviceCache();
+    auto current = getShared()->load();
 
-    for (const auto& cached: deviceCache)
+    for (const auto& cached: current->devices)
         if (cached.hasPlayback && cached.info.isDefaultOutput)
             return cached.info;
 
-    for (const auto& cached: deviceCache)
+    for (const auto& cached: current->devices)
         if (cached.hasPlayback)
             return cached.info;
 
     return {};
 }
 
-const ma_device_id* DeviceManager::findDeviceId(int makeASoundId) const
+std::uint64_t DeviceManager::getDevicesVersion()
 {
-    for (const auto& cached: deviceCache)
-        if (cached.id == makeASoundId)
-            return cached.hasPlayback ? &cached.playbackId : &cached.captureId;
+    return getShared()->getVersion();
+}
 
-    return nullptr;
+void DeviceManager::refreshDevices()
+{
+    getShared()->requestEnumeration();
 }
 
 Error DeviceManager::start(const StreamConfig& configToUse)
@@ -394,6 +268,7 @@ Error DeviceManager::start(const StreamConfig& configToUse)
     auto lock = std::lock_guard(deviceMutex);
 
     config = configToUse;
+    requestedConfig = configToUse;
 
     // The host's intent, not whether the open worked: a stream that couldn't find
     // its device is still meant to be running, which is what keeps recovery trying.
@@ -469,15 +344,18 @@ void DeviceManager::stopLocked()
     ma_device_uninit(&device);
     deviceInitialised = false;
     stopping = false;
+
+    // No audio thread any more, so nothing retired can still be pinned.
+    callback.reclaim();
 }
 
 Error DeviceManager::openStreamLocked()
 {
-    if (!contextInitialised)
+    if (!shared->isInitialised())
         return setError(Error::SYSTEM_ERROR);
 
-    if (deviceCache.empty())
-        refreshDeviceCache();
+    // Held until the open is done: the ids handed to miniaudio point into it.
+    auto devices = shared->load();
 
     // Answered here so the host is told there are no devices, rather than whatever
     // the backend makes of a stream with no sides to it.
@@ -489,26 +367,14 @@ Error DeviceManager::openStreamLocked()
 
     if (config.output.has_value())
     {
-        for (const auto& cached: deviceCache)
-        {
-            if (cached.id == config.output->device.id && cached.hasPlayback)
-            {
-                playbackId = &cached.playbackId;
-                break;
-            }
-        }
+        const auto* cached = devices->findById(config.output->device.id, false);
+        playbackId = cached != nullptr ? &cached->playbackId : nullptr;
     }
 
     if (config.input.has_value())
     {
-        for (const auto& cached: deviceCache)
-        {
-            if (cached.id == config.input->device.id && cached.hasCapture)
-            {
-                captureId = &cached.captureId;
-                break;
-            }
-        }
+        const auto* cached = devices->findById(config.input->device.id, true);
+        captureId = cached != nullptr ? &cached->captureId : nullptr;
     }
 
     auto nativePlayback =
@@ -525,7 +391,7 @@ Error DeviceManager::openStreamLocked()
     deviceConfig.notificationCallback = deviceNotificationCallback;
     deviceConfig.pUserData = this;
 
-    auto result = ma_device_init(&context, &deviceConfig, &device);
+    auto result = ma_device_init(shared->get(), &deviceConfig, &device);
 
     if (result != MA_SUCCESS)
         return setError(getError(result));
@@ -533,6 +399,10 @@ Error DeviceManager::openStreamLocked()
     deviceInitialised = true;
     framesElapsed = 0;
 
+    // Under Flags::fixedBlockSize the host's own block size is the contract, not a
+    // hint; the adapter makes up the difference to whatever was negotiated.
+    auto requestedBlockSize = config.maxBlockSize;
+
     config.maxBlockSize = static_cast<int>(
         std::max(device.playback.internalPeriodSizeInFrames,
                  device.capture.internalPeriodSizeInFrames));
@@ -540,32 +410,147 @@ Error DeviceManager::openStreamLocked()
     if (config.maxBlockSize == 0)
         config.maxBlockSize = static_cast<int>(deviceConfig.periodSizeInFrames);
 
+    if (config.maxBlockSize == 0)
+        config.maxBlockSize = kFallbackBlockSize;
+
+    fixedBlockCallback =
+        config.options.has_value() && config.options->flags.fixedBlockSize;
+
+    if (fixedBlockCallback && requestedBlockSize > 0)
+        config.maxBlockSize = requestedBlockSize;
+
     // What miniaudio negotiated is what the callback's interleaved buffers carry.
     captureChannels = static_cast<int>(device.capture.channels);
     playbackChannels = static_cast<int>(device.playback.channels);
 
-    auto clampSlice = [](int available, int first, int count, int& outFirst, int& outCount)
+    // No audio thread yet, so the slice is taken up here rather than at a block.
+    publishSlice();
+    applyPublishedSlice();
+
+    interleavedCallback = config.options.has_value()
+                          && !config.options->flags.nonInterleaved;
+    skipOutputClear =
+        config.options.has_value() && config.options->flags.skipOutputClear;
+
+    // Sized here, once, for the largest block the callback will ever be handed: a
+    // period that comes in longer is split rather than the scratch grown on the
+    // audio thread. Every native channel, not just the slice, so tryReconfigure can
+    // widen the slice without a reallocation. An interleaved stream hands the host
+    // the device's own buffers, so it has no use for planar copies of them.
+    auto scratchFrames = interleavedCallback ? 0 : config.maxBlockSize;
+
+    inputScratch.assign(captureChannels * scratchFrames, 0.0f);
+    outputScratch.assign(playbackChannels * scratchFrames, 0.0f);
+
+    // Empty unless used, so a stream that drops the flag gives the memory back.
+    if (fixedBlockCallback)
+        fixedBlockAdapter.prepare(
+            captureChannels, playbackChannels, config.maxBlockSize);
+    else
+        fixedBlockAdapter = FixedBlockAdapter {};
+
+    // Re-opening onto the same shape — a setConfig that changed only the callback, a
+    // recovery onto the same device — is not news to the host.
+    auto shape = AudioCallbackInfo {};
+    shape.numInputs = inputChannelCount;
+    shape.numOutputs = outputChannelCount;
+    shape.interleaved = interleavedCallback;
+    shape.inputStride = interleavedCallback ? captureChannels : 0;
+    shape.outputStride = interleavedCallback ? playbackChannels : 0;
+    shape.sampleRate = static_cast<int>(device.sampleRate);
+    shape.maxBlockSize = config.maxBlockSize;
+
+    if (shape != openedShape)
+    {
+        openedShape = shape;
+        generation.fetch_add(1, std::memory_order_release);
+    }
+
+    return setError(Error::NoError);
+}
+
+bool DeviceManager::tryReconfigure(const StreamConfig& next)
+{
+    auto lock = std::lock_guard(deviceMutex);
+
+    if (!deviceInitialised || !streamRunning
+        || needsNewDevice(requestedConfig, next))
+        return false;
+
+    requestedConfig = next;
+
+    // The slices only: config keeps the negotiated block size, and whatever device
+    // recovery re-pointed it to.
+    if (config.input.has_value())
+    {
+        config.input->firstChannel = next.input->firstChannel;
+        config.input->nChannels = next.input->nChannels;
+    }
+
+    if (config.output.has_value())
     {
-        outCount = std::clamp(count, 0, available);
-        outFirst = std::clamp(first, 0, std::max(0, available - outCount));
+        config.output->firstChannel = next.output->firstChannel;
+        config.output->nChannels = next.output->nChannels;
+    }
+
+    publishSlice();
+
+    // The audio thread moves the generation when it takes the slice up; this is only
+    // so the next open compares against the shape the host is now seeing.
+    auto slice = publishedSlice.load(std::memory_order_relaxed);
+    openedShape.numInputs = slice.inputCount;
+    openedShape.numOutputs = slice.outputCount;
+
+    return true;
+}
+
+void DeviceManager::publishSlice()
+{
+    auto clampSlice = [](int available,
+                         int first,
+                         int count,
+                         std::int16_t& outFirst,
+                         std::int16_t& outCount)
+    {
+        auto clampedCount = std::clamp(count, 0, available);
+        outCount = static_cast<std::int16_t>(clampedCount);
+        outFirst = static_cast<std::int16_t>(
+            std::clamp(first, 0, std::max(0, available - clampedCount)));
     };
 
+    auto slice = ChannelSlice {};
+
     clampSlice(captureChannels,
                config.input.has_value() ? config.input->firstChannel : 0,
                config.getInputChannels(),
-               inputFirstChannel,
-               inputChannelCount);
+               slice.inputFirst,
+               slice.inputCount);
 
     clampSlice(playbackChannels,
                config.output.has_value() ? config.output->firstChannel : 0,
                config.getOutputChannels(),
-               outputFirstChannel,
-               outputChannelCount);
+               slice.outputFirst,
+               slice.outputCount);
 
-    inputScratch.assign(inputChannelCount * config.maxBlockSize, 0.0f);
-    outputScratch.assign(outputChannelCount * config.maxBlockSize, 0.0f);
+    publishedSlice.store(slice, std::memory_order_release);
+}
 
-    return setError(Error::NoError);
+bool DeviceManager::applyPublishedSlice()
+{
+    auto slice = publishedSlice.load(std::memory_order_acquire);
+
+    if (slice.inputFirst == inputFirstChannel
+        && slice.inputCount == inputChannelCount
+        && slice.outputFirst == outputFirstChannel
+        && slice.outputCount == outputChannelCount)
+        return false;
+
+    inputFirstChannel = slice.inputFirst;
+    inputChannelCount = slice.inputCount;
+    outputFirstChannel = slice.outputFirst;
+    outputChannelCount = slice.outputCount;
+
+    return true;
 }
 
 long DeviceManager::getStreamLatency() const
@@ -578,7 +563,10 @@ long DeviceManager::getStreamLatency() const
     auto captureLatency = static_cast<long>(device.capture.internalPeriodSizeInFrames)
                           * static_cast<long>(device.capture.internalPeriods);
 
-    return std::max(playbackLatency, captureLatency);
+    auto adapterLatency =
+        fixedBlockCallback ? static_cast<long>(fixedBlockAdapter.getLatency()) : 0L;
+
+    return std::max(playbackLatency, captureLatency) + adapterLatency;
 }
 
 int DeviceManager::getStreamSampleRate() const
@@ -589,82 +577,218 @@ int DeviceManager::getStreamSampleRate() const
     return static_cast<int>(device.sampleRate);
 }
 
+AudioCallbackInfo DeviceManager::makeCallbackInfo(int frames)
+{
+    auto info = AudioCallbackInfo {};
+    info.numSamples = frames;
+    info.numInputs = inputChannelCount;
+    info.numOutputs = outputChannelCount;
+    info.sampleRate = static_cast<int>(device.sampleRate);
+    info.maxBlockSize = config.maxBlockSize;
+    info.latency = static_cast<int>(getStreamLatency());
+    info.streamTime =
+        static_cast<double>(framesElapsed) / static_cast<double>(device.sampleRate);
+    info.status = AudioCallbackStatus::OK;
+
+    return info;
+}
+
+void DeviceManager::invokeCallback(const Callback& cb, AudioCallbackInfo& info)
+{
+    // One integer compare, where comparing the whole info against the previous
+    // block's both cost more and fired on fields that change every block anyway.
+    info.generation = generation.load(std::memory_order_acquire);
+
+    if (info.generation != lastGeneration)
+    {
+        lastGeneration = info.generation;
+        info.dirty = true;
+    }
+
+    if (callbackChanged.exchange(false))
+        info.dirty = true;
+
+    cb(info);
+}
+
 void DeviceManager::onCallback(void* output, const void* input, ma_uint32 frameCount)
 {
     // Before the early-out: a stream whose host set no callback is still alive, and
     // this is the watchdog's only proof of it.
     lastCallbackMs = nowMs();
 
-    if (!callback)
+    // Pins the callback for the whole block, so a swap mid-block takes effect at the
+    // next one and the old callback is not freed while it is still running.
+    auto scope = callback.read();
+
+    if (!scope)
         return;
 
+    // Nothing from here on may allocate; this is what a test's operator new checks.
+    auto realtime = RealtimeScope {};
+
+    // Another slice is another shape: this block reads as dirty.
+    if (applyPublishedSlice())
+        generation.fetch_add(1, std::memory_order_release);
+
+    auto* out = static_cast<float*>(output);
+    auto* in = static_cast<const float*>(input);
     auto frames = static_cast<int>(frameCount);
-    auto inChannels = inputChannelCount;
-    auto outChannels = outputChannelCount;
 
-    auto neededInput = inChannels * frames;
-    auto neededOutput = outChannels * frames;
+    if (fixedBlockCallback)
+    {
+        fixedBlockAdapter.process(in,
+                                  out,
+                                  frames,
+                                  [&](const float* blockIn, float* blockOut)
+                                  {
+                                      runBlock(*scope.get(),
+                                               blockOut,
+                                               blockIn,
+                                               config.maxBlockSize);
+                                      framesElapsed += static_cast<ma_uint64>(
+                                          config.maxBlockSize);
+                                  });
+        return;
+    }
+
+    // miniaudio can hand over more than the period it reported — its duplex ring and
+    // its resampler both may — and the host was promised maxBlockSize at most. So a
+    // long period reaches the host as several blocks, each with its own streamTime.
+    auto blockSize = std::max(1, config.maxBlockSize);
+
+    for (auto offset = 0; offset < frames; offset += blockSize)
+    {
+        auto count = std::min(blockSize, frames - offset);
+        auto* blockOut = out != nullptr ? out + offset * playbackChannels : nullptr;
+        auto* blockIn = in != nullptr ? in + offset * captureChannels : nullptr;
+
+        runBlock(*scope.get(), blockOut, blockIn, count);
+        framesElapsed += static_cast<ma_uint64>(count);
+    }
+}
+
+void DeviceManager::runBlock(const Callback& cb,
+                             float* output,
+                             const float* input,
+                             int frames)
+{
+    if (interleavedCallback)
+        runInterleaved(cb, output, input, frames);
+    else
+        runPlanar(cb, output, input, frames);
+}
+
+void DeviceManager::setCallback(const Callback& cb)
+{
+    // An empty std::function is stored as no callback, so the audio thread has one
+    // null check and no std::function to test.
+    callback.set(cb ? std::make_unique<Callback>(cb) : nullptr);
+    callbackChanged = true;
+}
+
+bool DeviceManager::hasCallback() const
+{
+    return callback.hasValue();
+}
+
+void DeviceManager::runInterleaved(const Callback& cb,
+                                   float* output,
+                                   const float* input,
+                                   int frames)
+{
+    auto info = makeCallbackInfo(frames);
+    info.interleaved = true;
+
+    // Only ever read through getInterleavedInput(), which hands it back as const;
+    // the field is shared with the planar scratch, which is why it isn't const
+    // itself.
+    if (inputChannelCount > 0 && input != nullptr)
+    {
+        info.inputBuffer = const_cast<float*>(input) + inputFirstChannel;
+        info.inputStride = captureChannels;
+    }
+    else
+    {
+        info.numInputs = 0;
+    }
+
+    // miniaudio silences the playback buffer before every callback, so the channels
+    // outside the slice are already quiet — unless the host asked to skip that, in
+    // which case only they are cleared.
+    if (skipOutputClear && playbackChannels > 0 && output != nullptr)
+        clearOutsideSlice(output,
+                          playbackChannels,
+                          outputFirstChannel,
+                          outputChannelCount,
+                          frames);
+
+    if (outputChannelCount > 0 && output != nullptr)
+    {
+        info.outputBuffer = output + outputFirstChannel;
+        info.outputStride = playbackChannels;
+    }
+    else
+    {
+        info.numOutputs = 0;
+    }
 
-    if (static_cast<int>(inputScratch.size()) < neededInput)
-        inputScratch.assign(neededInput, 0.0f);
+    invokeCallback(cb, info);
+}
 
-    if (static_cast<int>(outputScratch.size()) < neededOutput)
-        outputScratch.assign(neededOutput, 0.0f);
+void DeviceManager::runPlanar(const Callback& cb,
+                              float* output,
+                              const float* input,
+                              int frames)
+{
+    // frames never exceeds maxBlockSize, which the scratch was sized for at open.
+    auto inChannels = inputChannelCount;
+    auto outChannels = outputChannelCount;
 
     if (inChannels > 0 && input != nullptr)
-        deinterleaveSlice(static_cast<const float*>(input),
+        deinterleaveSlice(input,
                           inputScratch.data(),
                           captureChannels,
                           inputFirstChannel,
                           inChannels,
                           frames);
 
-    if (outChannels > 0)
+    if (outChannels > 0 && !skipOutputClear)
         std::fill(outputScratch.begin(),
-                  outputScratch.begin() + neededOutput,
+                  outputScratch.begin() + outChannels * frames,
                   0.0f);
 
-    auto info = AudioCallbackInfo {};
+    auto info = makeCallbackInfo(frames);
     info.inputBuffer = inputScratch.data();
     info.outputBuffer = outputScratch.data();
-    info.numSamples = frames;
-    info.numInputs = inChannels;
-    info.numOutputs = outChannels;
-    info.sampleRate = static_cast<int>(device.sampleRate);
-    info.maxBlockSize = config.maxBlockSize;
-    info.latency = static_cast<int>(getStreamLatency());
-    info.streamTime =
-        static_cast<double>(framesElapsed) / static_cast<double>(device.sampleRate);
-    info.status = AudioCallbackStatus::OK;
 
-    if (notificationPending.exchange(false))
-        info.dirty = true;
-
-    callback(info);
+    invokeCallback(cb, info);
 
     // The device owns every native output channel but we fill only the selected
-    // slice, so clear the whole buffer first to keep the rest silent.
+    // slice, so clear the whole buffer first to keep the rest silent — or, when the
+    // host has promised to fill the slice, just the rest.
     if (playbackChannels > 0 && output != nullptr)
     {
-        auto* out = static_cast<float*>(output);
-        std::fill(out, out + playbackChannels * frames, 0.0f);
+        if (skipOutputClear)
+            clearOutsideSlice(
+                output, playbackChannels, outputFirstChannel, outChannels, frames);
+        else
+            std::fill(output, output + playbackChannels * frames, 0.0f);
 
         if (outChannels > 0)
             interleaveSlice(outputScratch.data(),
-                            out,
+                            output,
                             playbackChannels,
                             outputFirstChannel,
                             outChannels,
                             frames);
     }
-
-    framesElapsed += frameCount;
 }
 
 void DeviceManager::notifyHost(DeviceNotification notification)
 {
-    // Set even with no callback registered — the next audio callback consumes it.
-    notificationPending = true;
+    // Bumped even with no callback registered — the next audio callback sees it.
+    generation.fetch_add(1, std::memory_order_release);
 
     if (notificationCallback)
         notificationCallback(notification);
@@ -677,6 +801,10 @@ void DeviceManager::onNotification(ma_device_notification_type type)
 
     notifyHost(getNotification(type));
 
+    // Whatever happened to the stream may have happened to the device list: a
+    // reroute is a new default, a stop may be an unplug.
+    getShared()->requestEnumeration();
+
     // Handing `started` to the worker would tear down the stream that just came up.
     if (type == ma_device_notification_type_stopped && autoRecover)
         requestRecovery();
@@ -727,6 +855,11 @@ void DeviceManager::runRecovery()
         if (recoveryQuit)
             return;
 
+        // The one non-audio thread that runs on a timer whatever the host is doing,
+        // so a swapped-out callback is freed within an interval even if nobody swaps
+        // again.
+        callback.reclaim();
+
         auto starved = !recoveryRequested && isStarved();
 
         if (!recoveryRequested && !starved)
@@ -780,29 +913,31 @@ bool DeviceManager::tryReopen()
 
 void DeviceManager::repointConfigToCache()
 {
-    refreshDeviceCache();
+    // Fresh, not the snapshot: the device being waited for may have only just come
+    // back.
+    shared->refresh();
+    auto devices = shared->load();
 
-    auto repoint = [this](std::optional<StreamParameters>& params, bool input)
+    auto repoint = [&devices](std::optional<StreamParameters>& params, bool input)
     {
         if (!params.has_value())
             return;
 
-        for (const auto& cached: deviceCache)
-        {
-            if (cached.info.name != params->device.name)
-                continue;
-
-            if (input ? cached.hasCapture : cached.hasPlayback)
-            {
-                // Whole info, not just the id: the device may come back with other
-                // channel counts or rates, which the re-open negotiates against.
-                params->device = cached.info;
-                return;
-            }
-        }
+        // The id first, which a device keeps across a replug; the name for one that
+        // came back under another driver id, an ALSA card renumbered, say.
+        const auto* cached = devices->findById(params->device.id, input);
+
+        if (cached == nullptr)
+            cached = devices->findByName(params->device.name, input);
+
+        // Whole info, not just the id: the device may come back with other channel
+        // counts or rates, which the re-open negotiates against.
+        if (cached != nullptr)
+            params->device = cached->info;
 
-        // Nothing carries that name any more: openStream finds no cache entry, and
-        // passes a null device id, so miniaudio opens the system default.
+        // Otherwise nothing carries that id or name any more: openStream finds no
+        // cache entry, and passes a null device id, so miniaudio opens the system
+        // default.
     };
 
     repoint(config.input, true);
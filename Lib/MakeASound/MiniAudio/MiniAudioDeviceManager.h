@@ -1,10 +1,14 @@
 #pragma once
 
-#include "MiniAudio-Backend.h"
+#include "MiniAudioContext.h"
+#include "../Audio/FixedBlockAdapter.h"
+#include "../Realtime/HotSwapSlot.h"
+#include "../Realtime/RealtimeScope.h"
 
 #include <atomic>
 #include <cstdint>
 #include <condition_variable>
+#include <memory>
 #include <mutex>
 #include <thread>
 
@@ -23,18 +27,27 @@ struct DeviceManager
     DeviceManager();
     ~DeviceManager();
 
+    // Read from the shared context's published snapshot: no enumeration, and no
+    // waiting on a stream being opened or recovered. Only a call before the first
+    // snapshot enumerates.
     Vector<DeviceInfo> getDevices();
     DeviceInfo getDefaultInputDevice();
     DeviceInfo getDefaultOutputDevice();
 
-    // Probed once and remembered: each candidate costs a real connection attempt (a
-    // PulseAudio socket, a JACK handshake), and the set is far more stable than the
-    // device list.
-    const Vector<Backend>& getAvailableBackends();
+    // Moves each time a re-enumeration finds the list different; 0 before the first.
+    std::uint64_t getDevicesVersion();
+
+    // Asks the enumeration worker to look again now instead of at the next interval.
+    void refreshDevices();
+
+    // From the process's BackendProbe: each candidate costs a real connection
+    // attempt (a PulseAudio socket, a JACK handshake), and the set is far more
+    // stable than the device list.
+    Vector<Backend> getAvailableBackends();
     Backend getBackend() const;
 
-    // Whatever was running stops: the device and the device cache belong to the old
-    // context.
+    // Whatever was running stops: the device belongs to the old context. The manager
+    // moves to the context shared by everyone on the new backend.
     Error setBackend(Backend backendToUse);
 
     // On failure the recovery worker keeps retrying in the background, unless the
@@ -42,6 +55,14 @@ struct DeviceManager
     Error start(const StreamConfig& configToUse);
     void stop();
 
+    // Applies `next` to the running stream without touching the device, when all it
+    // changes is which of the device's channels the host sees — firstChannel or
+    // nChannels on a side already open. The audio thread picks the new slice up at
+    // its next block, and that block reads as dirty. False, with nothing changed,
+    // for anything that needs another device open: a different device, rate, block
+    // size, options, or a side added or dropped.
+    bool tryReconfigure(const StreamConfig& next);
+
     bool isRunning() const;
     Error getLastError() const;
 
@@ -51,25 +72,62 @@ struct DeviceManager
     void onCallback(void* output, const void* input, ma_uint32 frameCount);
     void onNotification(ma_device_notification_type type);
 
-    Callback callback;
+    // Any non-audio thread, stream running or not: the audio thread picks it up at
+    // the next block, and the one it replaces is destroyed off the audio thread.
+    void setCallback(const Callback& cb);
+    bool hasCallback() const;
+
     NotificationCallback notificationCallback;
     StreamConfig config;
 
     std::atomic<bool> autoRecover {true};
 
 private:
-    DeviceInfo buildDeviceInfo(const ma_device_info& enumInfo,
-                               ma_device_type type,
-                               int assignedId);
-    Error refreshDeviceCache();
-    const ma_device_id* findDeviceId(int makeASoundId) const;
+    // A copy, for callers not holding deviceMutex; setBackend swaps it.
+    std::shared_ptr<SharedContext> getShared() const;
+
+    // The channels of the device the host sees, small enough to reach the audio
+    // thread as one atomic word, so it never sees half of a change.
+    struct ChannelSlice
+    {
+        std::int16_t inputFirst = 0;
+        std::int16_t inputCount = 0;
+        std::int16_t outputFirst = 0;
+        std::int16_t outputCount = 0;
 
-    // Backend::Unknown brings the context up on miniaudio's default order;
-    // currentBackend records which API answered.
-    Error initContext(Backend backendToUse);
+        bool operator==(const ChannelSlice&) const = default;
+    };
+
+    // config's slices, clamped to the channels the device opened with, handed to the
+    // audio thread; deviceMutex held.
+    void publishSlice();
+
+    // Takes up the published slice: on the audio thread at the top of a block, or at
+    // an open before there is one. True if it differed from the one in use.
+    bool applyPublishedSlice();
 
     Error setError(Error error);
 
+    // The fields every callback shares, whichever way its buffers are laid out.
+    AudioCallbackInfo makeCallbackInfo(int frames);
+
+    // Raises dirty if the generation moved since the previous block or the callback
+    // is new, then calls the host.
+    void invokeCallback(const Callback& cb, AudioCallbackInfo& info);
+
+    // One block of at most maxBlockSize frames; the pointers are native interleaved
+    // buffers — the device's, or the fixed-block queues' — at the block's first
+    // frame.
+    void runBlock(const Callback& cb, float* output, const float* input, int frames);
+    void runInterleaved(const Callback& cb,
+                        float* output,
+                        const float* input,
+                        int frames);
+    void runPlanar(const Callback& cb,
+                   float* output,
+                   const float* input,
+                   int frames);
+
     // The *Locked variants assume deviceMutex is already held.
     Error startLocked();
     void stopLocked();
@@ -88,32 +146,20 @@ private:
     // calling back while the OS still believes the unit is running.
     bool isStarved() const;
 
-    // Cache ids are enumeration order, so they shift whenever a device appears or
-    // disappears; the name is what survives.
+    // Ids survive a device coming back with the same driver id; the name covers one
+    // that comes back with another.
     void repointConfigToCache();
 
-    ma_context context {};
-    bool contextInitialised = false;
+    std::shared_ptr<BackendProbe> backendProbe;
 
-    Backend currentBackend = Backend::Unknown;
-    Vector<Backend> availableBackends;
-    bool backendsProbed = false;
+    // Written under both deviceMutex and sharedMutex, so holding either is enough to
+    // read it; the device, when open, was opened on it.
+    std::shared_ptr<SharedContext> shared;
+    mutable std::mutex sharedMutex;
 
     ma_device device {};
     bool deviceInitialised = false;
 
-    struct CachedDevice
-    {
-        int id {};
-        ma_device_id playbackId {};
-        ma_device_id captureId {};
-        bool hasPlayback = false;
-        bool hasCapture = false;
-        DeviceInfo info {};
-    };
-
-    Vector<CachedDevice> deviceCache;
-
     Vector<float> inputScratch;
     Vector<float> outputScratch;
 
@@ -122,20 +168,60 @@ private:
     int captureChannels = 0;
     int playbackChannels = 0;
 
+    // Flags::nonInterleaved off: the callback gets the native buffers directly and
+    // the scratch buffers go unused.
+    bool interleavedCallback = false;
+
+    // Flags::skipOutputClear: the host writes the whole slice, so only the native
+    // channels outside it are zeroed, and nothing is cleared before the callback.
+    bool skipOutputClear = false;
+
+    // Flags::fixedBlockSize: every period goes through the adapter, which hands
+    // runBlock exactly maxBlockSize frames at a time.
+    bool fixedBlockCallback = false;
+    FixedBlockAdapter fixedBlockAdapter;
+
+    // Audio thread only while a device is open, copied from publishedSlice.
     int inputFirstChannel = 0;
     int inputChannelCount = 0;
     int outputFirstChannel = 0;
     int outputChannelCount = 0;
 
+    std::atomic<ChannelSlice> publishedSlice {};
+    static_assert(std::atomic<ChannelSlice>::is_always_lock_free);
+
+    // Guarded by deviceMutex: the config as the host last asked for it, before the
+    // open wrote the negotiated block size into `config` — what tryReconfigure
+    // compares against.
+    StreamConfig requestedConfig;
+
     ma_uint64 framesElapsed = 0;
 
     // Our own teardown makes the OS report a stop, indistinguishable at the callback
     // from the device going away. Raised across teardown so those are dropped.
     std::atomic<bool> stopping {false};
 
-    // Consumed by the next audio callback to raise AudioCallbackInfo::dirty, so a
-    // host with no notification callback still learns the stream changed under it.
-    std::atomic<bool> notificationPending {false};
+    // AudioCallbackInfo::generation. Bumped when an open changes the stream's shape,
+    // on a backend switch, and by every device notification — a reroute or an
+    // interruption leaves the shape alone but not the route — so a host with no
+    // notification callback still learns the stream changed under it. Starts ahead
+    // of lastGeneration so the very first block reads as dirty.
+    std::atomic<std::uint64_t> generation {1};
+
+    // Audio thread only: the generation the previous block carried.
+    std::uint64_t lastGeneration = 0;
+
+    // Guarded by deviceMutex: the shape of the last stream opened, which decides
+    // whether the next open bumps the generation.
+    AudioCallbackInfo openedShape;
+
+    // The host's callback, called directly from the audio thread — no wrapper.
+    // Swapped without a lock; the watchdog frees replaced ones.
+    HotSwapSlot<Callback> callback;
+
+    // A newly installed callback has cached nothing about the stream, so its first
+    // block reads as dirty however unchanged the shape is.
+    std::atomic<bool> callbackChanged {false};
 
     // A stream is open and started, as opposed to shouldRun, which is what the host
     // asked for: a machine with no device has shouldRun set and this clear.
@@ -143,7 +229,7 @@ private:
 
     std::atomic<Error> lastError {Error::NoError};
 
-    // Guards the device and the device cache, both touched by the recovery worker.
+    // Guards the device, which the recovery worker re-opens.
     std::mutex deviceMutex;
 
     // What the host asked for. Recovery re-opens only while true, so a stop() racing
@@ -24,28 +24,52 @@ Vector<MidiPortInfo> MidiManager::getOutputPorts()
 void MidiManager::openInput(int portId, const MidiInputCallback& cb)
 {
     closeInput(portId);
+    createInput(portId, cb, {}).rtIn->openPort(static_cast<unsigned int>(portId));
+}
 
-    auto& port = inputs.createNew();
-    port.portId = portId;
-    port.callback = cb;
-    port.rtIn = EA::makeOwned<::RtMidiIn>();
-    port.rtIn->setCallback(midiInputTrampoline, &port);
-    port.rtIn->openPort(static_cast<unsigned int>(portId));
+void MidiManager::openInput(int portId, const MidiRawInputCallback& cb)
+{
+    closeInput(portId);
+    createInput(portId, {}, cb).rtIn->openPort(static_cast<unsigned int>(portId));
 }
 
 int MidiManager::openVirtualInput(const std::string& name,
                                   const MidiInputCallback& cb)
 {
     auto portId = nextVirtualPortId--;
+    createInput(portId, cb, {}).rtIn->openVirtualPort(name);
+
+    return portId;
+}
+
+int MidiManager::openVirtualInput(const std::string& name,
+                                  const MidiRawInputCallback& cb)
+{
+    auto portId = nextVirtualPortId--;
+    createInput(portId, {}, cb).rtIn->openVirtualPort(name);
+
+    return portId;
+}
 
+InputPort& MidiManager::createInput(int portId,
+                                    const MidiInputCallback& cb,
+                                    const MidiRawInputCallback& rawCb)
+{
     auto& port = inputs.createNew();
     port.portId = portId;
     port.callback = cb;
+    port.rawCallback = rawCb;
     port.rtIn = EA::makeOwned<::RtMidiIn>();
+
+    if (port.isQueued() && sysExArenaSize > 0)
+    {
+        port.sysEx = EA::makeOwned<SysExStream>(sysExArenaSize);
+        port.rtIn->ignoreTypes(false, true, true);
+    }
+
     port.rtIn->setCallback(midiInputTrampoline, &port);
-    port.rtIn->openVirtualPort(name);
 
-    return portId;
+    return port;
 }
 
 void MidiManager::closeInput(int portId)
@@ -78,49 +102,94 @@ Vector<int> MidiManager::getOpenInputPorts() const
     return result;
 }
 
-void MidiManager::drainMessages(Vector<MidiInputEvent>& out)
+void MidiManager::drainMessages(MidiEvents& out, MidiTimePoint until)
+{
+    auto queueAt = [this](int i) -> MidiInputQueue*
+    {
+        auto& port = *inputs[i];
+        return port.isQueued() ? &port.queue : nullptr;
+    };
+
+    drainRotation.drain(static_cast<int>(inputs.size()), queueAt, out, until);
+}
+
+std::uint64_t MidiManager::getNumDroppedEvents(int portId) const
+{
+    for (auto& p: inputs)
+        if (p->portId == portId)
+            return p->queue.getDropped();
+
+    return 0;
+}
+
+void MidiManager::setSysExArenaSize(std::size_t bytes)
+{
+    sysExArenaSize = bytes;
+}
+
+int MidiManager::drainSysEx(const SysExCallback& deliver)
 {
+    auto count = 0;
+
     for (auto& port: inputs)
     {
-        if (port->callback)
+        if (!port->sysEx)
             continue;
 
-        if (!port->lock.tryLock())
-            continue;
+        auto portId = port->portId;
+        count += port->sysEx->drain([&](std::span<const std::uint8_t> message)
+                                    { deliver(portId, message); });
+    }
 
-        for (auto& evt: port->queue)
-            out.add(evt);
+    return count;
+}
 
-        port->queue.clear();
-        port->lock.unlock();
-    }
+std::uint64_t MidiManager::getNumDroppedSysEx(int portId) const
+{
+    for (auto& p: inputs)
+        if (p->portId == portId && p->sysEx)
+            return p->sysEx->getDropped();
+
+    return 0;
 }
 
 void MidiManager::openOutput(int portId)
 {
-    closeOutput();
+    auto lock = std::lock_guard(outputMutex);
+
+    if (output->isPortOpen())
+        output->closePort();
+
     output->openPort(static_cast<unsigned int>(portId));
 }
 
 void MidiManager::openVirtualOutput(const std::string& name)
 {
-    closeOutput();
+    auto lock = std::lock_guard(outputMutex);
+
+    if (output->isPortOpen())
+        output->closePort();
+
     output->openVirtualPort(name);
 }
 
 void MidiManager::closeOutput()
 {
+    auto lock = std::lock_guard(outputMutex);
+
     if (output->isPortOpen())
         output->closePort();
 }
 
 bool MidiManager::isOutputOpen() const
 {
+    auto lock = std::lock_guard(outputMutex);
     return output->isPortOpen();
 }
 
 void MidiManager::sendMessage(const std::uint8_t* bytes, std::size_t size)
 {
+    auto lock = std::lock_guard(outputMutex);
     output->sendMessage(bytes, size);
 }
 
@@ -144,6 +213,23 @@ void midiInputTrampoline(double timestamp,
         return;
     }
 
+    if (port.rawCallback)
+    {
+        port.rawCallback({message->data(), message->size()}, timestamp);
+        return;
+    }
+
+    // Every message moves the device clock on, even one that doesn't convert.
+    auto stamped = port.dejitter.stamp(timestamp, toSeconds(arrival));
+
+    // SysEx, or the rest of one a driver split: the port's arena, not the queue.
+    if (port.sysEx && !message->empty()
+        && (message->front() == 0xF0 || message->front() < 0x80))
+    {
+        port.sysEx->feed({message->data(), message->size()});
+        return;
+    }
+
     auto typed =
         MIDI::convertMidi(message->data(), static_cast<int>(message->size()));
     if (!typed)
@@ -152,10 +238,9 @@ void midiInputTrampoline(double timestamp,
     auto event = MidiInputEvent {};
     event.portId = port.portId;
     event.event = *typed;
-    event.arrival = arrival;
+    event.arrival = fromSeconds(stamped);
 
-    auto guard = EA::Locks::ScopedSpinLock {port.lock};
-    port.queue.add(event);
+    port.queue.push(event);
 }
 
 } // namespace MakeASound::RTMidi
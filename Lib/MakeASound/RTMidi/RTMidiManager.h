@@ -1,6 +1,12 @@
 #pragma once
 
 #include "RTMidi-Backend.h"
+#include "../MIDI/ClockSync.h"
+#include "../MIDI/MidiInputQueue.h"
+#include "../MIDI/SysExStream.h"
+
+#include <cstdint>
+#include <mutex>
 
 namespace MakeASound::RTMidi
 {
@@ -11,14 +17,21 @@ void midiInputTrampoline(double timestamp,
 
 struct InputPort
 {
-    InputPort() { queue.reserve(256); }
-
     int portId {};
     OwningPointer<::RtMidiIn> rtIn;
     MidiInputCallback callback;
+    MidiRawInputCallback rawCallback;
+
+    bool isQueued() const noexcept { return !callback && !rawCallback; }
 
-    EA::Locks::PrimitiveSpinLock lock;
-    Vector<MidiInputEvent> queue;
+    // Queue mode. RtMidi's thread pushes, the audio thread drains.
+    MidiInputQueue queue;
+
+    // RtMidi's thread only: turns its delta timestamps into queued arrival times.
+    ArrivalDejitter dejitter;
+
+    // Queue mode with SysEx enabled: where RtMidi's thread reassembles it.
+    OwningPointer<SysExStream> sysEx;
 };
 
 struct MidiManager
@@ -29,13 +42,21 @@ struct MidiManager
     Vector<MidiPortInfo> getOutputPorts();
 
     void openInput(int portId, const MidiInputCallback& cb);
+    void openInput(int portId, const MidiRawInputCallback& cb);
     int openVirtualInput(const std::string& name,
                          const MidiInputCallback& cb);
+    int openVirtualInput(const std::string& name,
+                         const MidiRawInputCallback& cb);
     void closeInput(int portId);
     void closeAllInputs();
     bool isInputOpen(int portId) const;
     Vector<int> getOpenInputPorts() const;
-    void drainMessages(Vector<MidiInputEvent>& out);
+    void drainMessages(MidiEvents& out, MidiTimePoint until);
+    std::uint64_t getNumDroppedEvents(int portId) const;
+
+    void setSysExArenaSize(std::size_t bytes);
+    int drainSysEx(const SysExCallback& deliver);
+    std::uint64_t getNumDroppedSysEx(int portId) const;
 
     void openOutput(int portId);
     void openVirtualOutput(const std::string& name);
@@ -45,14 +66,28 @@ struct MidiManager
     void sendMessage(const std::uint8_t* bytes, std::size_t size);
 
 private:
+    // Not yet open: the caller opens it as a system or a virtual port.
+    InputPort& createInput(int portId,
+                           const MidiInputCallback& cb,
+                           const MidiRawInputCallback& rawCb);
+
     OwningPointer<::RtMidiIn> inputEnumerator;
     OwningPointer<::RtMidiOut> outputEnumerator;
     OwningPointer<::RtMidiOut> output;
+
+    // The output is shared by whoever sends - the UI, a MidiOutputScheduler's
+    // sender - and whoever reopens it.
+    mutable std::mutex outputMutex;
     EA::OwnedVector<InputPort> inputs;
 
     // Virtual inputs have no system index, so they get negative ids that
     // cannot collide with the indices getInputPorts() returns.
     int nextVirtualPortId {-1};
+
+    std::size_t sysExArenaSize {0};
+
+    // Audio thread only.
+    MidiInputRotation drainRotation;
 };
 
 } // namespace MakeASound::RTMidi
@@ -0,0 +1,320 @@
+#pragma once
+
+#include "CacheLine.h"
+#include "DropCounter.h"
+#include "../Audio/Buffer.h"
+#include "../Audio/InterleavedBuffer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <vector>
+
+namespace MakeASound
+{
+
+// SPSCQueue for audio: a multichannel sample ring that one thread writes blocks into
+// and one other reads blocks out of, both wait-free and allocation-free once
+// prepared. What a disk recorder, a network sender or a meter hangs off the device
+// callback: the callback writes each block, the other thread reads at its own pace.
+//
+// Storage is planar, each channel a contiguous run of getCapacity() frames, so every
+// transfer is at most two memcpys per channel and the in-place regions below are
+// plain spans. Frames that don't fit on a write, and frames a read asks for that
+// aren't there, are counted — overruns on the producer's side, underruns on the
+// consumer's — so a host can tell a glitch from a quiet input after the fact.
+class AudioFifo
+{
+public:
+    // A run of frames, in FIFO order, for in-place access: per channel, at most two
+    // contiguous spans, the second non-empty only when the run wraps.
+    template <typename T>
+    class Region
+    {
+    public:
+        Region() noexcept = default;
+        Region(T* dataToUse,
+               int capacityToUse,
+               int startToUse,
+               int firstCountToUse,
+               int secondCountToUse) noexcept
+            : data(dataToUse)
+            , capacity(capacityToUse)
+            , start(startToUse)
+            , firstCount(firstCountToUse)
+            , secondCount(secondCountToUse)
+        {
+        }
+
+        int getNumSamples() const noexcept { return firstCount + secondCount; }
+        bool isEmpty() const noexcept { return getNumSamples() == 0; }
+
+        std::span<T> getFirst(int channel) const noexcept
+        {
+            return {channelData(channel) + start,
+                    static_cast<std::size_t>(firstCount)};
+        }
+
+        std::span<T> getSecond(int channel) const noexcept
+        {
+            return {channelData(channel), static_cast<std::size_t>(secondCount)};
+        }
+
+    private:
+        T* channelData(int channel) const noexcept
+        {
+            return data + static_cast<std::ptrdiff_t>(channel) * capacity;
+        }
+
+        T* data = nullptr;
+        int capacity = 0;
+        int start = 0;
+        int firstCount = 0;
+        int secondCount = 0;
+    };
+
+    AudioFifo() = default;
+
+    AudioFifo(int numChannelsToUse, int capacityToUse)
+    {
+        prepare(numChannelsToUse, capacityToUse);
+    }
+
+    // Not realtime, and neither side may be running: sizes the ring to `capacity`
+    // frames per channel, empties it and clears the counters.
+    void prepare(int numChannelsToUse, int capacityToUse)
+    {
+        numChannels = std::max(0, numChannelsToUse);
+        capacity = std::max(1, capacityToUse);
+
+        storage.assign(static_cast<std::size_t>(numChannels * capacity), 0.0f);
+        reset();
+    }
+
+    // Neither side may be running.
+    void reset() noexcept
+    {
+        producer.writeIndex.store(0, std::memory_order_relaxed);
+        producer.overruns.reset();
+        consumer.readIndex.store(0, std::memory_order_relaxed);
+        consumer.underruns.reset();
+    }
+
+    int getNumChannels() const noexcept { return numChannels; }
+
+    // Frames per channel; all of them usable.
+    int getCapacity() const noexcept { return capacity; }
+
+    // Either thread, or a third one. Exact only while both ends are idle.
+    int getNumReady() const noexcept
+    {
+        const auto read = consumer.readIndex.load(std::memory_order_acquire);
+        const auto write = producer.writeIndex.load(std::memory_order_acquire);
+
+        return static_cast<int>(write - read);
+    }
+
+    int getFreeSpace() const noexcept { return capacity - getNumReady(); }
+
+    // Frames dropped by write() for want of room, and frames read() had to make up
+    // with silence, since prepare(). Any thread.
+    std::uint64_t getOverruns() const noexcept
+    {
+        return producer.overruns.get();
+    }
+
+    std::uint64_t getUnderruns() const noexcept
+    {
+        return consumer.underruns.get();
+    }
+
+    // Producer thread only. Writes as many frames of `block` as fit and returns how
+    // many; the rest count as overruns. Channels beyond the FIFO's are ignored, and
+    // missing ones are written as silence.
+    int write(const Buffer& block) noexcept
+    {
+        auto region = writeAvailable();
+        auto count = std::min(block.getNumSamples(), region.getNumSamples());
+
+        for (auto ch = 0; ch < numChannels; ++ch)
+        {
+            auto first = region.getFirst(ch);
+            auto split = std::min(count, static_cast<int>(first.size()));
+
+            if (ch >= block.getNumChannels())
+            {
+                std::fill_n(first.begin(), split, 0.0f);
+                std::fill_n(region.getSecond(ch).begin(), count - split, 0.0f);
+                continue;
+            }
+
+            auto* src = block.getChannelPointer(ch);
+
+            copy(first.data(), src, split);
+            copy(region.getSecond(ch).data(), src + split, count - split);
+        }
+
+        commitWrite(count, block.getNumSamples() - count);
+        return count;
+    }
+
+    // Producer thread only. As above, from the device's interleaved frames.
+    int write(const InterleavedView<const float>& block) noexcept
+    {
+        auto region = writeAvailable();
+        auto count = std::min(block.getNumSamples(), region.getNumSamples());
+        auto channelsToCopy = std::min(numChannels, block.getNumChannels());
+
+        for (auto ch = 0; ch < numChannels; ++ch)
+        {
+            auto first = region.getFirst(ch);
+            auto second = region.getSecond(ch);
+            auto split = std::min(count, static_cast<int>(first.size()));
+
+            if (ch >= channelsToCopy)
+            {
+                std::fill_n(first.begin(), split, 0.0f);
+                std::fill_n(second.begin(), count - split, 0.0f);
+                continue;
+            }
+
+            auto src = block.getChannel(ch);
+
+            for (auto i = 0; i < split; ++i)
+                first[static_cast<std::size_t>(i)] = src[i];
+
+            for (auto i = split; i < count; ++i)
+                second[static_cast<std::size_t>(i - split)] = src[i];
+        }
+
+        commitWrite(count, block.getNumSamples() - count);
+        return count;
+    }
+
+    // Consumer thread only. Fills `destination` from the front of the FIFO and
+    // returns how many frames were there; the shortfall is filled with silence and
+    // counted as underruns. A reader that wants only what is ready, like a disk
+    // writer, asks getNumReady() first and passes a block that long.
+    int read(const Buffer& destination) noexcept
+    {
+        auto region = readAvailable();
+        auto wanted = destination.getNumSamples();
+        auto count = std::min(wanted, region.getNumSamples());
+
+        for (auto ch = 0; ch < destination.getNumChannels(); ++ch)
+        {
+            auto* dst = destination.getChannelPointer(ch);
+
+            if (ch >= numChannels)
+            {
+                std::fill_n(dst, wanted, 0.0f);
+                continue;
+            }
+
+            auto first = region.getFirst(ch);
+            auto second = region.getSecond(ch);
+            auto split = std::min(count, static_cast<int>(first.size()));
+
+            copy(dst, first.data(), split);
+            copy(dst + split, second.data(), count - split);
+            std::fill(dst + count, dst + wanted, 0.0f);
+        }
+
+        commitRead(count, wanted - count);
+        return count;
+    }
+
+    // Producer thread only. The free frames, to be written in place; none of it is
+    // visible to the consumer until commitWrite() publishes it.
+    Region<float> writeAvailable() noexcept
+    {
+        const auto write = producer.writeIndex.load(std::memory_order_relaxed);
+
+        // Acquire pairs with the consumer's release: the frames it frees are not
+        // overwritten until it has finished reading them.
+        const auto read = consumer.readIndex.load(std::memory_order_acquire);
+
+        return makeRegion(
+            storage.data(), write, capacity - static_cast<int>(write - read));
+    }
+
+    // Producer thread only. Publishes the first `count` frames of the last
+    // writeAvailable(), which must have offered at least that many, and adds
+    // `dropped` to the overrun count.
+    void commitWrite(int count, int dropped = 0) noexcept
+    {
+        const auto write = producer.writeIndex.load(std::memory_order_relaxed);
+
+        // Release pairs with the consumer's acquire: whoever sees the new index also
+        // sees the samples.
+        producer.writeIndex.store(write + static_cast<std::size_t>(count),
+                                  std::memory_order_release);
+
+        if (dropped > 0)
+            producer.overruns.add(static_cast<std::uint64_t>(dropped));
+    }
+
+    // Consumer thread only. The ready frames, to be read in place; they stay queued
+    // until commitRead() releases them to the producer.
+    Region<const float> readAvailable() const noexcept
+    {
+        const auto read = consumer.readIndex.load(std::memory_order_relaxed);
+        const auto write = producer.writeIndex.load(std::memory_order_acquire);
+
+        return makeRegion(storage.data(), read, static_cast<int>(write - read));
+    }
+
+    // Consumer thread only. Frees the first `count` frames of the last
+    // readAvailable(), which must have offered at least that many, and adds `missed`
+    // to the underrun count.
+    void commitRead(int count, int missed = 0) noexcept
+    {
+        const auto read = consumer.readIndex.load(std::memory_order_relaxed);
+        consumer.readIndex.store(read + static_cast<std::size_t>(count),
+                                 std::memory_order_release);
+
+        if (missed > 0)
+            consumer.underruns.add(static_cast<std::uint64_t>(missed));
+    }
+
+private:
+    static void copy(float* dst, const float* src, int count) noexcept
+    {
+        if (count > 0)
+            std::memcpy(dst, src, static_cast<std::size_t>(count) * sizeof(float));
+    }
+
+    // The indices run free; only the position in the ring wraps.
+    template <typename T>
+    Region<T> makeRegion(T* data, std::size_t index, int count) const noexcept
+    {
+        auto start = static_cast<int>(index % static_cast<std::size_t>(capacity));
+        auto firstCount = std::min(count, capacity - start);
+
+        return {data, capacity, start, firstCount, count - firstCount};
+    }
+
+    struct alignas(cacheLineSize) ProducerSide
+    {
+        std::atomic<std::size_t> writeIndex {0};
+        DropCounter overruns;
+    };
+
+    struct alignas(cacheLineSize) ConsumerSide
+    {
+        std::atomic<std::size_t> readIndex {0};
+        DropCounter underruns;
+    };
+
+    ProducerSide producer;
+    ConsumerSide consumer;
+
+    int numChannels = 0;
+    int capacity = 1;
+    std::vector<float> storage;
+};
+
+} // namespace MakeASound
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+namespace MakeASound
+{
+
+// The distance two atomics written by different threads have to be apart not to
+// share a cache line. std::hardware_destructive_interference_size would say, but GCC
+// and Clang warn on any use of it in a header — it follows -mtune, so it could give
+// one class two layouts in one program — so they get the known line sizes instead:
+// 128 on Apple silicon, 64 on x86 and every other ARM core we run on.
+#if defined(__cpp_lib_hardware_interference_size) && !defined(__GNUC__)
+inline constexpr std::size_t cacheLineSize =
+    std::hardware_destructive_interference_size;
+#elif defined(__APPLE__) && defined(__aarch64__)
+inline constexpr std::size_t cacheLineSize = 128;
+#else
+inline constexpr std::size_t cacheLineSize = 64;
+#endif
+
+} // namespace MakeASound
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace MakeASound
+{
+
+// How much one thread had to give up - posts a full queue refused, messages too long
+// to keep, frames with no room - readable from any thread. Only that thread counts,
+// so a count is a relaxed load and store rather than a read-modify-write: no locked
+// instruction on a realtime path.
+class DropCounter
+{
+public:
+    // The counting thread only.
+    void count() noexcept { add(1); }
+
+    // The counting thread only.
+    void add(std::uint64_t amount) noexcept
+    {
+        dropped.store(dropped.load(std::memory_order_relaxed) + amount,
+                      std::memory_order_relaxed);
+    }
+
+    // Not while the counting thread is counting.
+    void reset() noexcept { dropped.store(0, std::memory_order_relaxed); }
+
+    // Any thread.
+    std::uint64_t get() const noexcept
+    {
+        return dropped.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<std::uint64_t> dropped {0};
+};
+
+} // namespace MakeASound
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace MakeASound
+{
+
+// One object, replaced from any non-realtime thread while exactly one realtime
+// thread reads it — the audio callback picking up a new processor at the next block,
+// with no lock and no re-open. RCU-style: the reader only bumps a counter on the way
+// in and on the way out, and an object it might still be holding is retired rather
+// than freed; reclaim() frees it later, on a writer's thread, once the counter shows
+// the reader has moved on. So destroying T never happens on the audio thread, and T
+// may own anything.
+template <typename T>
+class HotSwapSlot
+{
+public:
+    // Pins whatever was current on entry for as long as the scope lives. Realtime
+    // thread only, one at a time; wait-free and allocation-free.
+    class ReadScope
+    {
+    public:
+        explicit ReadScope(HotSwapSlot& slotToUse) noexcept
+            : slot(slotToUse)
+        {
+            // Odd while inside. Sequentially consistent, as is the writer's exchange
+            // and counter read: either the writer sees us inside, or we see its new
+            // pointer — never neither.
+            slot.readerCount.fetch_add(1);
+            object = slot.current.load();
+        }
+
+        ~ReadScope() { slot.readerCount.fetch_add(1); }
+
+        ReadScope(const ReadScope&) = delete;
+        ReadScope& operator=(const ReadScope&) = delete;
+
+        T* get() const noexcept { return object; }
+        T* operator->() const noexcept { return object; }
+        explicit operator bool() const noexcept { return object != nullptr; }
+
+    private:
+        HotSwapSlot& slot;
+        T* object = nullptr;
+    };
+
+    HotSwapSlot() = default;
+    HotSwapSlot(const HotSwapSlot&) = delete;
+    HotSwapSlot& operator=(const HotSwapSlot&) = delete;
+
+    // The reader has to be gone by now — its stream stopped — so nothing is pinned.
+    ~HotSwapSlot()
+    {
+        delete current.exchange(nullptr);
+
+        auto lock = std::lock_guard(retiredMutex);
+
+        for (auto& entry: retired)
+            delete entry.object;
+    }
+
+    ReadScope read() noexcept { return ReadScope(*this); }
+
+    // Non-realtime threads. Live from the reader's next scope on; null empties the
+    // slot. The object it replaces is retired, then freed by this or a later
+    // reclaim() once the reader can no longer be holding it.
+    void set(std::unique_ptr<T> next)
+    {
+        auto* previous = current.exchange(next.release());
+
+        auto lock = std::lock_guard(retiredMutex);
+
+        if (previous != nullptr)
+            retired.push_back({previous, readerCount.load()});
+
+        reclaimLocked();
+    }
+
+    // Non-realtime threads. Cheap when there is nothing retired, so it can sit on a
+    // timer.
+    void reclaim()
+    {
+        auto lock = std::lock_guard(retiredMutex);
+        reclaimLocked();
+    }
+
+    // A snapshot for non-realtime callers; by the time it returns it may be stale.
+    bool hasValue() const noexcept { return current.load() != nullptr; }
+
+    // Retired objects still waiting for the reader to move on.
+    int getNumPending()
+    {
+        auto lock = std::lock_guard(retiredMutex);
+        return static_cast<int>(retired.size());
+    }
+
+private:
+    struct Retired
+    {
+        T* object = nullptr;
+
+        // The reader's counter when this was swapped out: even means it was
+        // outside any scope then, so any later scope sees the replacement; odd means
+        // that one scope may still hold it, until the counter moves.
+        std::uint64_t readerCountAtRetire = 0;
+    };
+
+    void reclaimLocked()
+    {
+        if (retired.empty())
+            return;
+
+        auto now = readerCount.load();
+
+        std::erase_if(retired,
+                      [now](const Retired& entry)
+                      {
+                          auto quiescent = entry.readerCountAtRetire % 2 == 0
+                                           || now != entry.readerCountAtRetire;
+
+                          if (quiescent)
+                              delete entry.object;
+
+                          return quiescent;
+                      });
+    }
+
+    std::atomic<T*> current {nullptr};
+    std::atomic<std::uint64_t> readerCount {0};
+
+    std::mutex retiredMutex;
+    std::vector<Retired> retired;
+};
+
+} // namespace MakeASound
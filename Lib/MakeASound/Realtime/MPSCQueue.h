@@ -0,0 +1,129 @@
+#pragma once
+
+#include "CacheLine.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace MakeASound
+{
+
+// Bounded FIFO for any number of pushing threads and exactly one popping thread —
+// the UI, a MIDI thread and an OSC thread all posting to the audio thread. Each
+// slot carries a sequence number that says whose turn it is: a producer claims a
+// slot with one CAS on the shared write index, fills it, and hands it over by
+// bumping the slot's sequence, so the consumer needs no CAS at all.
+//
+// The consumer is wait-free and allocation-free, so pop() is safe on the audio
+// thread. Producers are lock-free rather than wait-free: under contention a push
+// may retry its CAS. A producer stalled between claiming a slot and filling it holds
+// back the elements behind it until it resumes; pop() reports empty meanwhile rather
+// than waiting, so the audio thread picks them up a block later.
+//
+// Capacity is a power of two, and all of it is usable.
+template <typename T, std::size_t Capacity>
+class MPSCQueue
+{
+public:
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "MPSCQueue needs a power-of-two capacity of at least two");
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "MPSCQueue elements are copied across threads; keep them PODs");
+
+    MPSCQueue() noexcept
+    {
+        for (auto i = std::size_t {0}; i < Capacity; ++i)
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    static constexpr std::size_t capacity() noexcept { return Capacity; }
+
+    // Any thread but the consumer. Returns false and drops the item when full.
+    bool push(const T& item) noexcept
+    {
+        auto write = writeIndex.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            auto& cell = cells[write & mask];
+            const auto sequence = cell.sequence.load(std::memory_order_acquire);
+            const auto lag = static_cast<std::intptr_t>(sequence)
+                             - static_cast<std::intptr_t>(write);
+
+            if (lag == 0)
+            {
+                // Free and ours to claim, if no other producer got there first. On
+                // failure `write` is reloaded and we try the slot it now names.
+                if (writeIndex.compare_exchange_weak(
+                        write, write + 1, std::memory_order_relaxed))
+                {
+                    cell.value = item;
+
+                    // Release pairs with the consumer's acquire: whoever sees the
+                    // new sequence also sees the value.
+                    cell.sequence.store(write + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (lag < 0)
+            {
+                // The slot still holds what the consumer has not popped from the
+                // previous lap: full.
+                return false;
+            }
+            else
+            {
+                // Another producer claimed this slot since we loaded the index.
+                write = writeIndex.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consumer thread only. Leaves `out` untouched when empty.
+    bool pop(T& out) noexcept
+    {
+        const auto read = readIndex.load(std::memory_order_relaxed);
+        auto& cell = cells[read & mask];
+
+        if (cell.sequence.load(std::memory_order_acquire) != read + 1)
+            return false;
+
+        out = cell.value;
+
+        // Release pairs with the producers' acquire: the slot is not claimed for the
+        // next lap until we have finished reading it.
+        cell.sequence.store(read + Capacity, std::memory_order_release);
+        readIndex.store(read + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Any thread. Claimed slots, including ones a producer is still filling; exact
+    // only while every end is idle.
+    std::size_t sizeApprox() const noexcept
+    {
+        const auto read = readIndex.load(std::memory_order_relaxed);
+        const auto write = writeIndex.load(std::memory_order_relaxed);
+
+        return write > read ? write - read : 0;
+    }
+
+private:
+    static constexpr std::size_t mask = Capacity - 1;
+
+    struct Cell
+    {
+        std::atomic<std::size_t> sequence {0};
+        T value {};
+    };
+
+    // The index every producer contends on, away from the consumer's and from the
+    // slots, so the contention stays on the producers' side.
+    alignas(cacheLineSize) std::atomic<std::size_t> writeIndex {0};
+    alignas(cacheLineSize) std::atomic<std::size_t> readIndex {0};
+    alignas(cacheLineSize) std::array<Cell, Capacity> cells {};
+};
+
+} // namespace MakeASound
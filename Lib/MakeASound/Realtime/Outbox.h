@@ -0,0 +1,123 @@
+#pragma once
+
+#include "DropCounter.h"
+#include "PaddedSPSCQueue.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace MakeASound
+{
+
+// Messages from the audio thread to the UI: the audio thread posts into a
+// preallocated ring — no allocation, no lock, no message-loop call per message —
+// and a UI-thread timer drains it in batches.
+//
+// A message posted with a key is state rather than an event: a meter level, a
+// controller position. When one batch holds several with the same key, only the
+// last is delivered, in its own place in the order, so a dense stream of them
+// costs the UI one update per key per drain however fast the audio thread posts.
+// Unkeyed messages are all delivered.
+//
+// Capacity is a power of two. When the UI falls a whole ring behind, posts fail
+// and are counted rather than blocking the audio thread.
+template <typename T, std::size_t Capacity>
+class Outbox
+{
+public:
+    static constexpr int noKey = -1;
+
+    Outbox() { batch.resize(Capacity); }
+
+    // Audio thread only. `key` is a small non-negative integer, or noKey. Returns
+    // false, and counts the message as dropped, when the ring is full.
+    bool post(const T& message, int key = noKey) noexcept
+    {
+        if (queue.push({key, message}))
+            return true;
+
+        dropped.count();
+        return false;
+    }
+
+    // UI thread only. Calls deliver(const T&) for what is queued — at most one
+    // ring's worth — in posting order, with repeated keys coalesced, and returns
+    // how many were delivered.
+    template <typename Fn>
+    int drain(Fn&& deliver)
+    {
+        auto count = std::size_t {0};
+
+        while (count < Capacity && queue.pop(batch[count]))
+            ++count;
+
+        markSuperseded(count);
+
+        auto delivered = 0;
+
+        for (auto i = std::size_t {0}; i < count; ++i)
+        {
+            const auto& entry = batch[i];
+
+            if (entry.key == superseded)
+                continue;
+
+            deliver(entry.message);
+            ++delivered;
+        }
+
+        return delivered;
+    }
+
+    // Any thread. Messages post() refused since construction.
+    std::uint64_t getDropped() const noexcept
+    {
+        return dropped.get();
+    }
+
+private:
+    static constexpr int superseded = -2;
+
+    struct Entry
+    {
+        int key = noKey;
+        T message {};
+    };
+
+    // Walks the batch backwards, so the first time a key is seen is its last
+    // occurrence; every earlier one is marked to be skipped. `lastDrain` records
+    // which drain last saw each key, so it never needs clearing.
+    void markSuperseded(std::size_t count)
+    {
+        ++drainNumber;
+
+        for (auto i = count; i-- > 0;)
+        {
+            auto key = batch[i].key;
+
+            if (key < 0)
+                continue;
+
+            auto index = static_cast<std::size_t>(key);
+
+            if (index >= lastDrain.size())
+                lastDrain.resize(index + 1, 0);
+
+            if (lastDrain[index] == drainNumber)
+                batch[i].key = superseded;
+            else
+                lastDrain[index] = drainNumber;
+        }
+    }
+
+    PaddedSPSCQueue<Entry, Capacity> queue;
+    DropCounter dropped;
+
+    // UI-thread scratch.
+    std::vector<Entry> batch;
+    std::vector<std::uint64_t> lastDrain;
+    std::uint64_t drainNumber = 0;
+};
+
+} // namespace MakeASound
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "CacheLine.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace MakeASound
+{
+
+// SPSCQueue's contract — one pusher, one popper, wait-free, allocation-free, T a
+// small POD — built for throughput rather than footprint:
+//
+//  - The two indices sit on cache lines of their own, away from each other and from
+//    the slots, so a push doesn't invalidate the line the consumer is polling.
+//  - Capacity is a power of two and the indices run free, so wrapping is a mask
+//    and all Capacity slots are usable; none is held back to tell full from empty.
+//  - Each side keeps a plain copy of the other's index and reloads the atomic only
+//    when that copy says full (or empty). While the queue is neither, a push or pop
+//    touches no line the other thread writes.
+//
+// It costs a few cache lines of padding, which is why SPSCQueue stays the default
+// for small queues that are mostly idle.
+template <typename T, std::size_t Capacity>
+class PaddedSPSCQueue
+{
+public:
+    static_assert(Capacity >= 1 && (Capacity & (Capacity - 1)) == 0,
+                  "PaddedSPSCQueue needs a power-of-two capacity");
+
+    static constexpr std::size_t capacity() noexcept { return Capacity; }
+
+    // Producer thread only. Returns false and drops the item when full.
+    bool push(const T& item) noexcept
+    {
+        const auto write = producer.writeIndex.load(std::memory_order_relaxed);
+
+        if (write - producer.cachedReadIndex == Capacity)
+        {
+            // Acquire pairs with the consumer's release: the slot it frees is not
+            // reused until it has finished reading it.
+            producer.cachedReadIndex =
+                consumer.readIndex.load(std::memory_order_acquire);
+
+            if (write - producer.cachedReadIndex == Capacity)
+                return false;
+        }
+
+        buffer[write & mask] = item;
+        producer.writeIndex.store(write + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer thread only. Leaves `out` untouched when empty.
+    bool pop(T& out) noexcept
+    {
+        const auto read = consumer.readIndex.load(std::memory_order_relaxed);
+
+        if (read == consumer.cachedWriteIndex)
+        {
+            // Acquire pairs with the producer's release: whoever sees the new index
+            // also sees the slot's contents.
+            consumer.cachedWriteIndex =
+                producer.writeIndex.load(std::memory_order_acquire);
+
+            if (read == consumer.cachedWriteIndex)
+                return false;
+        }
+
+        out = buffer[read & mask];
+        consumer.readIndex.store(read + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Either thread, or a third one: how many elements are queued. Exact only while
+    // both ends are idle.
+    std::size_t sizeApprox() const noexcept
+    {
+        const auto read = consumer.readIndex.load(std::memory_order_acquire);
+        const auto write = producer.writeIndex.load(std::memory_order_acquire);
+
+        return write - read;
+    }
+
+private:
+    static constexpr std::size_t mask = Capacity - 1;
+
+    // Each side's own index, next to its copy of the other's: everything the
+    // producer writes on one line, everything the consumer writes on another.
+    struct alignas(cacheLineSize) ProducerSide
+    {
+        std::atomic<std::size_t> writeIndex {0};
+        std::size_t cachedReadIndex = 0;
+    };
+
+    struct alignas(cacheLineSize) ConsumerSide
+    {
+        std::atomic<std::size_t> readIndex {0};
+        std::size_t cachedWriteIndex = 0;
+    };
+
+    ProducerSide producer;
+    ConsumerSide consumer;
+    alignas(cacheLineSize) std::array<T, Capacity> buffer {};
+};
+
+} // namespace MakeASound
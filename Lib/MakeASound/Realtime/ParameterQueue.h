@@ -0,0 +1,70 @@
+#pragma once
+
+#include "MPSCQueue.h"
+
+#include <cstddef>
+#include <type_traits>
+#include <variant>
+
+namespace MakeASound
+{
+
+// Parameter changes for the audio thread, posted from anywhere. Each message is one
+// of a fixed set of small structs — SetGain, NoteOn, AllNotesOff — so a change that
+// spans several values travels as one unit and can't be seen half-applied, and
+// changes are applied in the order they were posted, which separate atomics can't
+// promise.
+//
+//     struct SetGain { float gain; };
+//     struct AllNotesOff {};
+//
+//     template <typename... Fs>
+//     struct Overloaded : Fs... { using Fs::operator()...; };
+//
+//     ParameterQueue<64, SetGain, AllNotesOff> changes;
+//
+//     changes.post(SetGain {0.5f});                // UI thread
+//
+//     changes.applyPending(Overloaded {            // audio thread, block start
+//         [&](const SetGain& m) { gain = m.gain; },
+//         [&](const AllNotesOff&) { voices.releaseAll(); },
+//     });
+template <std::size_t Capacity, typename... Messages>
+class ParameterQueue
+{
+public:
+    using Message = std::variant<Messages...>;
+
+    static_assert((std::is_trivially_copyable_v<Messages> && ...),
+                  "ParameterQueue messages are copied across threads; "
+                  "keep them PODs");
+
+    // Any thread but the audio thread. Returns false and drops the change when the
+    // queue is full — the audio thread has fallen a whole queue behind.
+    bool post(const Message& message) noexcept { return queue.push(message); }
+
+    // Audio thread only, once at the start of each block. Calls `apply` with each
+    // pending message, in posting order, and returns how many. Stops after one
+    // queue's worth, so producers posting flat out can't hold the block up.
+    template <typename Visitor>
+    int applyPending(Visitor&& apply)
+    {
+        auto message = Message {};
+        auto applied = 0;
+
+        while (applied < static_cast<int>(Capacity) && queue.pop(message))
+        {
+            std::visit(apply, message);
+            ++applied;
+        }
+
+        return applied;
+    }
+
+    std::size_t sizeApprox() const noexcept { return queue.sizeApprox(); }
+
+private:
+    MPSCQueue<Message, Capacity> queue;
+};
+
+} // namespace MakeASound
@@ -0,0 +1,32 @@
+#pragma once
+
+namespace MakeASound
+{
+
+// Marks the calling thread as running realtime code for as long as the scope lives —
+// the audio callback wraps each block in one. It enforces nothing by itself: it is
+// what lets a replaced operator new, a debug allocator or a test tell an allocation
+// on the audio thread from the same allocation anywhere else. Nests, costs a
+// thread-local increment, and never allocates.
+class RealtimeScope
+{
+public:
+    RealtimeScope() noexcept { ++depth(); }
+    ~RealtimeScope() { --depth(); }
+
+    RealtimeScope(const RealtimeScope&) = delete;
+    RealtimeScope& operator=(const RealtimeScope&) = delete;
+
+    static bool isActive() noexcept { return depth() > 0; }
+
+private:
+    // A function-local thread_local rather than a static member, so the one counter
+    // is shared by the library and whatever test binary links it.
+    static int& depth() noexcept
+    {
+        thread_local auto value = 0;
+        return value;
+    }
+};
+
+} // namespace MakeASound
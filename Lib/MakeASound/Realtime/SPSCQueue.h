@@ -1,8 +1,10 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <cstddef>
+#include <span>
 
 namespace MakeASound
 {
@@ -11,12 +13,30 @@ namespace MakeASound
 // what keeps both ends wait-free and allocation-free (safe on an audio thread)
 // with plain acquire/release and no CAS loop. T is assigned across the fence,
 // so keep it a small POD. One slot is held back to tell full from empty.
+//
+// The bulk calls move a whole run for one acquire and one release, where push/pop
+// pay both per element: draining a thousand events is two atomic round trips, not
+// two thousand.
 template <typename T, std::size_t Capacity>
 class SPSCQueue
 {
 public:
     static_assert(Capacity >= 1, "SPSCQueue needs room for at least one element");
 
+    // A run of slots, in queue order, as at most two contiguous spans: `second` is
+    // non-empty only when the run wraps past the end of the ring.
+    template <typename U>
+    struct Region
+    {
+        std::span<U> first;
+        std::span<U> second;
+
+        std::size_t size() const noexcept { return first.size() + second.size(); }
+        bool empty() const noexcept { return size() == 0; }
+    };
+
+    static constexpr std::size_t capacity() noexcept { return Capacity; }
+
     // Producer thread only. Returns false and drops the item when full.
     bool push(const T& item) noexcept
     {
@@ -50,6 +70,83 @@ public:
         return true;
     }
 
+    // Producer thread only. Pushes as many of `items` as fit, in order, and returns
+    // how many; the rest are the caller's to retry or drop.
+    std::size_t pushBulk(std::span<const T> items) noexcept
+    {
+        auto region = writeAvailable();
+        auto count = std::min(items.size(), region.size());
+        auto split = std::min(count, region.first.size());
+
+        std::copy_n(items.begin(), split, region.first.begin());
+        std::copy_n(items.begin() + split, count - split, region.second.begin());
+
+        commitWrite(count);
+        return count;
+    }
+
+    // Consumer thread only. Pops up to out.size() elements into the front of `out`
+    // and returns how many.
+    std::size_t popBulk(std::span<T> out) noexcept
+    {
+        auto region = readAvailable();
+        auto count = std::min(out.size(), region.size());
+        auto split = std::min(count, region.first.size());
+
+        std::copy_n(region.first.begin(), split, out.begin());
+        std::copy_n(region.second.begin(), count - split, out.begin() + split);
+
+        commitRead(count);
+        return count;
+    }
+
+    // Producer thread only. The free slots, to be written in place; none of it is
+    // visible to the consumer until commitWrite() publishes it.
+    Region<T> writeAvailable() noexcept
+    {
+        const auto write = writeIndex.load(std::memory_order_relaxed);
+        const auto read = readIndex.load(std::memory_order_acquire);
+
+        return makeRegion<T>(write, Capacity - distance(read, write));
+    }
+
+    // Producer thread only. Publishes the first `count` slots of the last
+    // writeAvailable(), which must have offered at least that many.
+    void commitWrite(std::size_t count) noexcept
+    {
+        const auto write = writeIndex.load(std::memory_order_relaxed);
+        writeIndex.store((write + count) % bufferSize, std::memory_order_release);
+    }
+
+    // Consumer thread only. The queued elements, to be read in place; they stay
+    // queued until commitRead() releases them to the producer.
+    Region<const T> readAvailable() noexcept
+    {
+        const auto read = readIndex.load(std::memory_order_relaxed);
+        const auto write = writeIndex.load(std::memory_order_acquire);
+
+        return makeRegion<const T>(read, distance(read, write));
+    }
+
+    // Consumer thread only. Frees the first `count` elements of the last
+    // readAvailable(), which must have offered at least that many.
+    void commitRead(std::size_t count) noexcept
+    {
+        const auto read = readIndex.load(std::memory_order_relaxed);
+        readIndex.store((read + count) % bufferSize, std::memory_order_release);
+    }
+
+    // Either thread, or a third one: how many elements are queued. Exact only while
+    // both ends are idle; otherwise somewhere between what it was when the call
+    // began and what it is when it returns.
+    std::size_t sizeApprox() const noexcept
+    {
+        const auto read = readIndex.load(std::memory_order_acquire);
+        const auto write = writeIndex.load(std::memory_order_acquire);
+
+        return distance(read, write);
+    }
+
 private:
     static constexpr std::size_t bufferSize = Capacity + 1;
 
@@ -58,6 +155,21 @@ private:
         return (index + 1) % bufferSize;
     }
 
+    // Elements from `from` up to, not including, `to`, going round the ring.
+    static std::size_t distance(std::size_t from, std::size_t to) noexcept
+    {
+        return (to + bufferSize - from) % bufferSize;
+    }
+
+    template <typename U>
+    Region<U> makeRegion(std::size_t start, std::size_t count) noexcept
+    {
+        auto firstCount = std::min(count, bufferSize - start);
+
+        return {std::span<U>(buffer.data() + start, firstCount),
+                std::span<U>(buffer.data(), count - firstCount)};
+    }
+
     std::array<T, bufferSize> buffer {};
     std::atomic<std::size_t> writeIndex {0};
     std::atomic<std::size_t> readIndex {0};
@@ -0,0 +1,129 @@
+// Tests for the allocation-free sorts in Common/Algorithms.h and the MIDI::Buffer
+// ordering built on them. The cases pin stability above all - a note-off queued
+// before a note-on at the same offset has to come out first - and then the run
+// merge: sorted runs appended one after another, as each port's events are, come
+// out as one sorted sequence however many there are and however uneven their sizes.
+
+#include <MakeASound/Common/Algorithms.h>
+#include <MakeASound/MIDI/MIDI.h>
+
+#include <NanoTest/NanoTest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace nano;
+namespace Algorithms = MakeASound::Algorithms;
+namespace MIDI = MakeASound::MIDI;
+
+namespace
+{
+struct Item
+{
+    int key = 0;
+    int seq = 0;
+};
+
+bool byKey(const Item& a, const Item& b) noexcept
+{
+    return a.key < b.key;
+}
+
+bool sameOrder(const std::vector<Item>& a, const std::vector<Item>& b)
+{
+    return std::equal(a.begin(),
+                      a.end(),
+                      b.begin(),
+                      b.end(),
+                      [](const Item& x, const Item& y)
+                      { return x.key == y.key && x.seq == y.seq; });
+}
+
+// `runs` ascending runs of random lengths, back to back, with plenty of ties.
+std::vector<Item> makeRuns(std::mt19937& rng, int runs, int maxRunLength)
+{
+    auto items = std::vector<Item> {};
+
+    for (auto run = 0; run < runs; ++run)
+    {
+        auto length =
+            static_cast<int>(rng() % static_cast<unsigned>(maxRunLength + 1));
+        auto key = 0;
+
+        for (auto i = 0; i < length; ++i)
+        {
+            key += static_cast<int>(rng() % 3);
+            items.push_back({key, static_cast<int>(items.size())});
+        }
+    }
+
+    return items;
+}
+
+auto tRuns = test("Algorithms/runMergeSortMatchesStableSortOnRuns") = []
+{
+    auto rng = std::mt19937 {7};
+    auto ok = true;
+
+    for (auto trial = 0; trial < 500; ++trial)
+    {
+        auto items = makeRuns(rng, 1 + trial % 17, 40);
+        auto expected = items;
+        std::stable_sort(expected.begin(), expected.end(), byKey);
+
+        auto scratch = std::vector<Item>(items.size());
+        Algorithms::stableRunMergeSort(items, scratch, byKey);
+
+        ok = ok && sameOrder(items, expected);
+    }
+
+    check(ok);
+};
+
+auto tRandom = test("Algorithms/runMergeSortMatchesStableSortOnShuffledInput") = []
+{
+    auto rng = std::mt19937 {11};
+    auto ok = true;
+
+    for (auto trial = 0; trial < 200; ++trial)
+    {
+        auto items = std::vector<Item>(static_cast<std::size_t>(trial * 3));
+
+        for (auto i = 0; i < static_cast<int>(items.size()); ++i)
+            items[static_cast<std::size_t>(i)] = {static_cast<int>(rng() % 16), i};
+
+        auto expected = items;
+        std::stable_sort(expected.begin(), expected.end(), byKey);
+
+        auto scratch = std::vector<Item>(items.size());
+        Algorithms::stableRunMergeSort(items, scratch, byKey);
+
+        ok = ok && sameOrder(items, expected);
+    }
+
+    check(ok);
+};
+
+auto tMidi = test("MidiBuffer/sortByOffsetWithScratchKeepsTiesInOrder") = []
+{
+    // Two ports' worth, appended: the second port's note-on at 10 must land after
+    // the first port's note-off at 10.
+    auto events = MIDI::Buffer {};
+    events.add(MIDI::Event::noteOn(0, 60, 1.0f, 0));
+    events.add(MIDI::Event::noteOff(0, 60, 0.0f, 10));
+    events.add(MIDI::Event::noteOn(0, 62, 1.0f, 20));
+    events.add(MIDI::Event::controlChange(1, 1, 0.5f, 5));
+    events.add(MIDI::Event::noteOn(1, 60, 1.0f, 10));
+
+    auto scratch = std::vector<MIDI::Event>(8);
+    events.sortByOffset(scratch);
+
+    const int offsets[] = {0, 5, 10, 10, 20};
+
+    for (auto i = 0; i < 5; ++i)
+        check(events[i].sampleOffset == offsets[i]);
+
+    check(events[2].isNoteOff() && events[3].isNoteOn());
+};
+} // namespace
@@ -0,0 +1,237 @@
+// Tests for MakeASound::AudioFifo - the multichannel sample ring between the device
+// callback and a recorder, sender or meter thread. The single-threaded cases pin the
+// block transfers, the wrap, the in-place regions and the overrun / underrun counts;
+// the concurrent case runs a real writer against a real reader and proves every
+// channel's samples cross intact, once each and in order.
+
+#include <MakeASound/Realtime/AudioFifo.h>
+
+#include <NanoTest/NanoTest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace nano;
+using MakeASound::AudioFifo;
+using MakeASound::Buffer;
+
+namespace
+{
+constexpr auto channels = 2;
+
+// Sample `frame` of channel `channel`, distinct everywhere and exact in a float.
+float sampleAt(int frame, int channel)
+{
+    return static_cast<float>(frame * channels + channel + 1);
+}
+
+// A planar block of `frames` frames, starting at absolute frame `first`.
+std::vector<float> makeBlock(int first, int frames)
+{
+    auto block = std::vector<float>(static_cast<std::size_t>(channels * frames));
+
+    for (auto ch = 0; ch < channels; ++ch)
+        for (auto i = 0; i < frames; ++i)
+            block[static_cast<std::size_t>(ch * frames + i)] =
+                sampleAt(first + i, ch);
+
+    return block;
+}
+
+bool holdsFrames(const std::vector<float>& block, int first, int frames)
+{
+    for (auto ch = 0; ch < channels; ++ch)
+        for (auto i = 0; i < frames; ++i)
+            if (block[static_cast<std::size_t>(ch * frames + i)]
+                != sampleAt(first + i, ch))
+                return false;
+
+    return true;
+}
+
+auto tRoundTrip = test("AudioFifo/readsBackWhatWasWritten") = []
+{
+    auto fifo = AudioFifo(channels, 64);
+    auto in = makeBlock(0, 16);
+
+    check(fifo.write(Buffer(in.data(), channels, 16)) == 16);
+    check(fifo.getNumReady() == 16);
+    check(fifo.getFreeSpace() == 48);
+
+    auto out = std::vector<float>(in.size());
+    check(fifo.read(Buffer(out.data(), channels, 16)) == 16);
+    check(holdsFrames(out, 0, 16));
+    check(fifo.getNumReady() == 0);
+    check(fifo.getOverruns() == 0 && fifo.getUnderruns() == 0);
+};
+
+auto tWrap = test("AudioFifo/wrapsAroundTheRing") = []
+{
+    // Capacity 10, blocks of 7: almost every transfer straddles the end of the ring.
+    auto fifo = AudioFifo(channels, 10);
+    auto ok = true;
+
+    for (auto frame = 0; frame < 700; frame += 7)
+    {
+        auto in = makeBlock(frame, 7);
+        ok = ok && fifo.write(Buffer(in.data(), channels, 7)) == 7;
+
+        auto out = std::vector<float>(in.size());
+        ok = ok && fifo.read(Buffer(out.data(), channels, 7)) == 7;
+        ok = ok && holdsFrames(out, frame, 7);
+    }
+
+    check(ok);
+};
+
+auto tOverrun = test("AudioFifo/countsTheFramesAWriteDrops") = []
+{
+    auto fifo = AudioFifo(channels, 10);
+    auto in = makeBlock(0, 16);
+
+    check(fifo.write(Buffer(in.data(), channels, 16)) == 10);
+    check(fifo.getOverruns() == 6);
+    check(fifo.write(Buffer(in.data(), channels, 16)) == 0);
+    check(fifo.getOverruns() == 22);
+
+    // What did fit is the front of the block.
+    auto out = std::vector<float>(static_cast<std::size_t>(channels * 10));
+    check(fifo.read(Buffer(out.data(), channels, 10)) == 10);
+    check(holdsFrames(out, 0, 10));
+};
+
+auto tUnderrun = test("AudioFifo/fillsAShortReadWithSilenceAndCountsIt") = []
+{
+    auto fifo = AudioFifo(channels, 32);
+    auto in = makeBlock(0, 4);
+    fifo.write(Buffer(in.data(), channels, 4));
+
+    auto out = std::vector<float>(static_cast<std::size_t>(channels * 8), -1.0f);
+    check(fifo.read(Buffer(out.data(), channels, 8)) == 4);
+    check(fifo.getUnderruns() == 4);
+
+    for (auto ch = 0; ch < channels; ++ch)
+        for (auto i = 0; i < 8; ++i)
+            check(out[static_cast<std::size_t>(ch * 8 + i)]
+                  == (i < 4 ? sampleAt(i, ch) : 0.0f));
+};
+
+auto tInterleaved = test("AudioFifo/writesInterleavedFramesAsPlanar") = []
+{
+    auto fifo = AudioFifo(channels, 16);
+    auto frames = std::vector<float>(static_cast<std::size_t>(channels * 8));
+
+    for (auto i = 0; i < 8; ++i)
+        for (auto ch = 0; ch < channels; ++ch)
+            frames[static_cast<std::size_t>(i * channels + ch)] = sampleAt(i, ch);
+
+    check(fifo.write(MakeASound::InterleavedView<const float>(
+              frames.data(), channels, 8, channels))
+          == 8);
+
+    auto out = std::vector<float>(frames.size());
+    check(fifo.read(Buffer(out.data(), channels, 8)) == 8);
+    check(holdsFrames(out, 0, 8));
+};
+
+auto tInPlace = test("AudioFifo/regionsSplitAtTheEndOfTheRing") = []
+{
+    auto fifo = AudioFifo(channels, 8);
+    auto in = makeBlock(0, 6);
+    fifo.write(Buffer(in.data(), channels, 6));
+
+    auto out = std::vector<float>(in.size());
+    fifo.read(Buffer(out.data(), channels, 6));
+
+    // Six frames consumed: the next eight free frames are 6, 7, then 0 to 5.
+    auto region = fifo.writeAvailable();
+    check(region.getNumSamples() == 8);
+    check(region.getFirst(0).size() == 2 && region.getSecond(0).size() == 6);
+
+    for (auto ch = 0; ch < channels; ++ch)
+    {
+        auto frame = 100;
+
+        for (auto& sample: region.getFirst(ch))
+            sample = sampleAt(frame++, ch);
+
+        for (auto& sample: region.getSecond(ch))
+            sample = sampleAt(frame++, ch);
+    }
+
+    check(fifo.getNumReady() == 0);
+    fifo.commitWrite(8);
+    check(fifo.getNumReady() == 8);
+
+    auto ready = fifo.readAvailable();
+    check(ready.getNumSamples() == 8);
+    check(ready.getFirst(1)[0] == sampleAt(100, 1));
+    check(ready.getSecond(1)[5] == sampleAt(107, 1));
+
+    fifo.commitRead(8);
+    check(fifo.getNumReady() == 0);
+};
+
+auto tConcurrent =
+    test("AudioFifo/concurrentWriterReaderDeliversEverythingInOrder") = []
+{
+    // Odd block sizes on both sides and a ring that is not a multiple of either, so
+    // the two ends drift through every alignment.
+    constexpr auto totalFrames = 200'000;
+    constexpr auto writeBlock = 37;
+    constexpr auto readBlock = 53;
+
+    auto fifo = AudioFifo(channels, 301);
+    std::atomic<bool> ok {true};
+
+    auto reader = std::thread(
+        [&]
+        {
+            auto out =
+                std::vector<float>(static_cast<std::size_t>(channels * readBlock));
+
+            for (auto frame = 0; frame < totalFrames;)
+            {
+                auto count =
+                    std::min({fifo.getNumReady(), readBlock, totalFrames - frame});
+
+                // Nothing there: let the writer run rather than spin out the rest
+                // of this thread's time slice.
+                if (count == 0)
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                fifo.read(Buffer(out.data(), channels, count));
+
+                if (!holdsFrames(out, frame, count))
+                    ok.store(false, std::memory_order_relaxed);
+
+                frame += count;
+            }
+        });
+
+    for (auto frame = 0; frame < totalFrames;)
+    {
+        auto count =
+            std::min({fifo.getFreeSpace(), writeBlock, totalFrames - frame});
+
+        if (count == 0)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        auto in = makeBlock(frame, count);
+        fifo.write(Buffer(in.data(), channels, count));
+        frame += count;
+    }
+
+    reader.join();
+
+    check(ok.load(std::memory_order_relaxed));
+    check(fifo.getOverruns() == 0 && fifo.getUnderruns() == 0);
+};
+} // namespace
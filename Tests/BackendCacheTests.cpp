@@ -0,0 +1,102 @@
+// Tests for the backend cache - the file the last probe's answer is kept in between
+// runs. They point it at a scratch directory and pin the round trip: what is saved
+// reads back as it was, nothing is left behind but the cache file itself, and an
+// empty directory keeps nothing at all.
+
+#include <MakeASound/Devices/BackendCache.h>
+
+#include <NanoTest/NanoTest.h>
+
+#include <filesystem>
+#include <system_error>
+
+using namespace nano;
+using MakeASound::Backend;
+using MakeASound::Vector;
+namespace fs = std::filesystem;
+
+namespace
+{
+// Empty, and the cache's directory until the test is done with it.
+struct ScratchDirectory
+{
+    ScratchDirectory()
+    {
+        auto error = std::error_code {};
+        fs::remove_all(path, error);
+        MakeASound::setBackendCacheDirectory(path);
+    }
+
+    ~ScratchDirectory()
+    {
+        MakeASound::setBackendCacheDirectory({});
+
+        auto error = std::error_code {};
+        fs::remove_all(path, error);
+    }
+
+    int countFiles() const
+    {
+        auto count = 0;
+        auto error = std::error_code {};
+
+        for (auto it = fs::recursive_directory_iterator {path, error};
+             it != fs::recursive_directory_iterator {};
+             ++it)
+            if (it->is_regular_file())
+                ++count;
+
+        return count;
+    }
+
+    fs::path path = fs::temp_directory_path() / "MakeASoundBackendCacheTests";
+};
+
+auto tRoundTrip = test("BackendCache/readsBackWhatWasSaved") = []
+{
+    auto scratch = ScratchDirectory {};
+    check(!MakeASound::loadCachedBackends().has_value());
+
+    auto backends = Vector<Backend> {};
+    backends.add(Backend::PulseAudio);
+    backends.add(Backend::ALSA);
+    backends.add(Backend::Null);
+
+    MakeASound::saveCachedBackends(backends);
+    auto loaded = MakeASound::loadCachedBackends();
+
+    check(loaded.has_value());
+    check(loaded.has_value() && loaded->size() == backends.size());
+
+    for (auto i = 0; loaded.has_value() && i < static_cast<int>(loaded->size()); ++i)
+        check((*loaded)[i] == backends[i]);
+
+    // Saved again over the first: still the one file, with no temporary left over.
+    MakeASound::saveCachedBackends(backends);
+    check(scratch.countFiles() == 1);
+};
+
+auto tEmptyList = test("BackendCache/keepsAProbeThatFoundNothing") = []
+{
+    auto scratch = ScratchDirectory {};
+
+    MakeASound::saveCachedBackends({});
+    auto loaded = MakeASound::loadCachedBackends();
+
+    check(loaded.has_value() && loaded->empty());
+};
+
+auto tOff = test("BackendCache/emptyDirectoryKeepsNothing") = []
+{
+    auto scratch = ScratchDirectory {};
+    MakeASound::setBackendCacheDirectory({});
+
+    auto backends = Vector<Backend> {};
+    backends.add(Backend::Null);
+
+    MakeASound::saveCachedBackends(backends);
+
+    check(!MakeASound::loadCachedBackends().has_value());
+    check(scratch.countFiles() == 0);
+};
+} // namespace
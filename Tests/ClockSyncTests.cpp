@@ -0,0 +1,138 @@
+// Tests for ClockSync - the audio-to-MIDI clock fit and the per-port arrival
+// dejitter MidiBlockSync maps MIDI input through. The fit cases pin the line
+// through jittery readings of two drifting clocks, from the first reading on and
+// however far from zero both clocks are; the dejitter cases pin rebuilt arrival
+// times that lose the scheduling delay but never come out later than the message
+// really arrived.
+
+#include <MakeASound/MIDI/ClockSync.h>
+
+#include <NanoTest/NanoTest.h>
+
+#include <cmath>
+#include <random>
+
+using namespace nano;
+using MakeASound::ArrivalDejitter;
+using MakeASound::LinearClockFit;
+
+namespace
+{
+constexpr auto microsecond = 1.0e-6;
+
+auto tFitOneReading = test("ClockSync/fitWithOneReadingRunsAtNominalRate") = []
+{
+    auto fit = LinearClockFit {};
+    fit.add(10.0, 500.0);
+
+    check(fit.getSlope() == 1.0);
+    check(std::abs(fit.map(10.5) - 500.5) < microsecond);
+    check(std::abs(fit.unmap(499.0) - 9.0) < microsecond);
+};
+
+// A device clock 100 ppm slow, read by a callback that runs up to 2 ms late, a
+// block at a time, long after boot.
+auto tFitDrift = test("ClockSync/fitRecoversDriftThroughJitter") = []
+{
+    auto rng = std::mt19937 {7};
+    auto lateness = std::uniform_real_distribution<double> {0.0, 0.002};
+
+    constexpr auto boot = 250'000.0;
+    constexpr auto rate = 1.0001;
+    constexpr auto block = 512.0 / 48000.0;
+
+    auto fit = LinearClockFit {};
+    auto streamTime = 0.0;
+
+    for (auto i = 0; i < 5000; ++i, streamTime += block)
+        fit.add(streamTime, boot + rate * streamTime + lateness(rng));
+
+    check(std::abs(fit.getSlope() - rate) < 2.0e-5);
+
+    // The line sits in the middle of the lateness, about 1 ms above the true one.
+    auto expected = boot + rate * streamTime + 0.001;
+    check(std::abs(fit.map(streamTime) - expected) < 200 * microsecond);
+    check(std::abs(fit.unmap(fit.map(streamTime)) - streamTime) < microsecond);
+};
+
+auto tFitReset = test("ClockSync/resetForgetsReadings") = []
+{
+    auto fit = LinearClockFit {};
+
+    for (auto i = 0; i < 100; ++i)
+        fit.add(i * 0.01, i * 0.02);
+
+    check(std::abs(fit.getSlope() - 2.0) < 0.01);
+
+    fit.reset();
+    check(fit.empty());
+    check(fit.getSlope() == 1.0);
+};
+
+// Messages every 5 ms by the device's clock, each callback delayed by 0.2 to 3 ms;
+// the least-delayed ones pin the floor.
+auto tDejitter = test("ClockSync/dejitterRemovesDeliveryDelay") = []
+{
+    auto rng = std::mt19937 {3};
+    auto delay = std::uniform_real_distribution<double> {0.0002, 0.003};
+
+    auto dejitter = ArrivalDejitter {};
+    auto sent = 1000.0;
+    auto worst = 0.0;
+
+    for (auto i = 0; i < 1000; ++i)
+    {
+        auto delta = i == 0 ? 0.0 : 0.005;
+        sent += delta;
+
+        auto arrival = sent + (i == 0 ? 0.0002 : delay(rng));
+        auto stamped = dejitter.stamp(delta, arrival);
+
+        check(stamped <= arrival);
+
+        if (i > 0)
+            worst = std::max(worst, std::abs(stamped - (sent + 0.0002)));
+    }
+
+    // The floor creeps up between the rare least-delayed messages, so what's left
+    // is a fraction of the 2.8 ms the callbacks spread over.
+    check(worst < 200 * microsecond);
+};
+
+// A device clock 50 ppm slow: over a minute the offset climbs 3 ms, and the floor
+// has to climb with it rather than stamp everything earlier and earlier.
+auto tDejitterDrift = test("ClockSync/dejitterFollowsSlowDeviceClock") = []
+{
+    auto dejitter = ArrivalDejitter {};
+    auto steady = 0.0;
+    auto stamped = 0.0;
+
+    for (auto i = 0; i < 6000; ++i)
+    {
+        auto delta = i == 0 ? 0.0 : 0.01;
+        steady += delta * 1.00005;
+        stamped = dejitter.stamp(delta, steady);
+
+        check(stamped <= steady);
+    }
+
+    check(steady - stamped < 10 * microsecond);
+};
+
+// Timestamps that jump - a driver reset - can't be trusted across the jump; the
+// next arrival is taken as it is.
+auto tDejitterResync = test("ClockSync/dejitterResyncsOnTimestampJump") = []
+{
+    auto dejitter = ArrivalDejitter {};
+
+    dejitter.stamp(0.0, 100.0);
+    dejitter.stamp(0.01, 100.01);
+
+    // The device says 5 s passed; steady_clock says 20 ms.
+    auto stamped = dejitter.stamp(5.0, 100.03);
+    check(std::abs(stamped - 100.03) < microsecond);
+
+    stamped = dejitter.stamp(0.01, 100.04);
+    check(std::abs(stamped - 100.04) < microsecond);
+};
+} // namespace
@@ -0,0 +1,148 @@
+// Tests for how a device list is put together from what the driver enumerates: the
+// ids hashed from each device's driver id and name, how a collision between two of
+// them is settled, and which capture side joins which playback device. They build
+// the snapshot by hand, so they need no backend and hold for any machine.
+
+#include <MakeASound/MiniAudio/MiniAudioContext.h>
+
+#include <NanoTest/NanoTest.h>
+
+#include <cstring>
+#include <limits>
+#include <set>
+#include <string>
+
+using namespace nano;
+using MakeASound::DeviceInfo;
+using MakeASound::MiniAudio::makeDeviceId;
+using Snapshot = MakeASound::MiniAudio::SharedContext::DeviceSnapshot;
+
+namespace
+{
+// A driver id whose bytes start with `value` and are zero after it, as miniaudio
+// leaves them.
+ma_device_id makeDriverId(int value)
+{
+    auto id = ma_device_id {};
+    std::memset(&id, 0, sizeof(id));
+    std::memcpy(&id, &value, sizeof(value));
+    return id;
+}
+
+DeviceInfo makeInfo(const std::string& name, int outputs, int inputs)
+{
+    auto info = DeviceInfo {};
+    info.name = name;
+    info.outputChannels = outputs;
+    info.inputChannels = inputs;
+    return info;
+}
+
+auto tDeterministic = test("DeviceId/sameDeviceGetsTheSameId") = []
+{
+    check(makeDeviceId(makeDriverId(7), "USB Audio")
+          == makeDeviceId(makeDriverId(7), "USB Audio"));
+};
+
+auto tPositive = test("DeviceId/neverZeroOrNegative") = []
+{
+    for (auto i = 0; i < 10'000; ++i)
+        check(makeDeviceId(makeDriverId(i), "Device " + std::to_string(i)) > 0);
+
+    check(makeDeviceId(makeDriverId(0), "") > 0);
+};
+
+auto tInputs = test("DeviceId/changesWithEitherTheDriverIdOrTheName") = []
+{
+    auto id = makeDeviceId(makeDriverId(1), "USB Audio");
+
+    check(makeDeviceId(makeDriverId(2), "USB Audio") != id);
+    check(makeDeviceId(makeDriverId(1), "USB Audio 2") != id);
+
+    // Spread, not just different: a thousand neighbours, a thousand ids.
+    auto seen = std::set<int> {};
+
+    for (auto i = 0; i < 1000; ++i)
+        seen.insert(makeDeviceId(makeDriverId(i), "USB Audio"));
+
+    check(seen.size() == 1000);
+};
+
+auto tClaim = test("DeviceId/collisionTakesTheNextFreeId") = []
+{
+    auto snapshot = Snapshot {};
+    snapshot.byId.emplace(10, 0);
+    snapshot.byId.emplace(11, 1);
+
+    check(snapshot.claimId(9) == 9);
+    check(snapshot.claimId(10) == 12);
+    check(snapshot.claimId(11) == 12);
+};
+
+auto tClaimWraps = test("DeviceId/collisionWrapsPastTheLargestId") = []
+{
+    constexpr auto largest = std::numeric_limits<int>::max();
+
+    auto snapshot = Snapshot {};
+    snapshot.byId.emplace(largest, 0);
+    check(snapshot.claimId(largest) == 1);
+
+    snapshot.byId.emplace(1, 1);
+    check(snapshot.claimId(largest) == 2);
+};
+
+auto tSameDevice = test("DeviceId/twoIdenticalDevicesGetTheirOwnIds") = []
+{
+    // Same driver id and name, so the same hash: the second moves up one.
+    auto snapshot = Snapshot {};
+    snapshot.addPlayback(makeDriverId(3), makeInfo("USB Audio", 2, 0));
+    snapshot.addPlayback(makeDriverId(3), makeInfo("USB Audio", 2, 0));
+
+    check(snapshot.devices.size() == 2);
+
+    auto first = snapshot.devices[0].id;
+    auto expected = first == std::numeric_limits<int>::max() ? 1 : first + 1;
+
+    check(snapshot.devices[1].id == expected);
+    check(snapshot.devices[0].info.id == first);
+    check(snapshot.devices[1].info.id == expected);
+};
+
+auto tPairing = test("DeviceId/pairsSidesOfOneNameInOrder") = []
+{
+    // Two of one interface: each input joins its own output, in the order the
+    // driver listed them, rather than both landing on the first.
+    auto snapshot = Snapshot {};
+    snapshot.addPlayback(makeDriverId(1), makeInfo("USB Audio", 2, 0));
+    snapshot.addPlayback(makeDriverId(2), makeInfo("USB Audio", 8, 0));
+    snapshot.addCapture(makeDriverId(3), makeInfo("USB Audio", 0, 2));
+    snapshot.addCapture(makeDriverId(4), makeInfo("USB Audio", 0, 8));
+    snapshot.addCapture(makeDriverId(5), makeInfo("Mic", 0, 1));
+
+    check(snapshot.devices.size() == 3);
+
+    const auto& first = snapshot.devices[0];
+    const auto& second = snapshot.devices[1];
+
+    check(first.hasCapture && second.hasCapture);
+    check(first.info.duplexChannels == 2);
+    check(second.info.duplexChannels == 8);
+
+    auto firstInput = makeDriverId(3);
+    auto secondInput = makeDriverId(4);
+    check(ma_device_id_equal(&first.captureId, &firstInput));
+    check(ma_device_id_equal(&second.captureId, &secondInput));
+    check(first.id != second.id);
+
+    // An input of another name is a device of its own.
+    check(!snapshot.devices[2].hasPlayback && snapshot.devices[2].hasCapture);
+
+    // By id, every device; by name, the first with that side.
+    for (const auto& device: snapshot.devices)
+        check(snapshot.findById(device.id, device.hasCapture) == &device);
+
+    check(snapshot.findByName("USB Audio", true) == &first);
+    check(snapshot.findByName("USB Audio", false) == &first);
+    check(snapshot.findByName("Mic", false) == nullptr);
+};
+} // namespace
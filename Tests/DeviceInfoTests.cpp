@@ -278,6 +278,51 @@ auto tCallbackBuffers = test("AudioCallbackInfo/handsOutCorrectlyShapedBuffers")
     check(input.getChannelPointer(0) == inputSamples.data());
 };
 
+auto tInterleavedBuffers =
+    test("AudioCallbackInfo/handsOutTheNativeFramesWhenInterleaved") = []
+{
+    // Channels 1-2 of a 4-wide device, 3 frames: the buffers point at the first
+    // selected channel and the stride is the device's full width.
+    auto native = std::array<float, 12> {};
+
+    auto info = AudioCallbackInfo {};
+    info.interleaved = true;
+    info.numOutputs = 2;
+    info.numInputs = 2;
+    info.numSamples = 3;
+    info.outputBuffer = native.data() + 1;
+    info.outputStride = 4;
+    info.inputBuffer = native.data() + 1;
+    info.inputStride = 4;
+
+    auto output = info.getInterleavedOutput();
+    check(output.getNumChannels() == 2);
+    check(output.getNumSamples() == 3);
+    check(output.getStride() == 4);
+    check(&output.getSample(1, 2) == native.data() + 2 * 4 + 2);
+
+    auto input = info.getInterleavedInput();
+    check(input.getFrame(1) == native.data() + 5);
+
+    // The planar accessors would read frames as channels, so they come back empty.
+    check(info.getOutput().isEmpty());
+    check(info.getInput().isEmpty());
+};
+
+auto tPlanarHasNoInterleaved =
+    test("AudioCallbackInfo/planarStreamHasNoInterleavedViews") = []
+{
+    auto samples = std::array<float, 8> {};
+
+    auto info = AudioCallbackInfo {};
+    info.numOutputs = 2;
+    info.numSamples = 4;
+    info.outputBuffer = samples.data();
+
+    check(info.getInterleavedOutput().isEmpty());
+    check(info.getInterleavedInput().isEmpty());
+};
+
 auto tEqualityShape = test("AudioCallbackInfo/comparesOnlyTheStreamShape") = []
 {
     // This is what drives the dirty flag: a block that differs only in
@@ -294,6 +339,7 @@ auto tEqualityShape = test("AudioCallbackInfo/comparesOnlyTheStreamShape") = []
     second.dirty = true;
     second.errorCode = 3;
     second.numSamples = 64;
+    second.generation = 42;
 
     check(first == second);
     check(!(first != second));
@@ -318,5 +364,9 @@ auto tEqualityDetectsChange = test("AudioCallbackInfo/detectsAStreamShapeChange"
     auto channelsChanged = first;
     channelsChanged.numOutputs = 1;
     check(first != channelsChanged);
+
+    auto layoutChanged = first;
+    layoutChanged.interleaved = true;
+    check(first != layoutChanged);
 };
 } // namespace
@@ -2,18 +2,94 @@
 // DeviceInfo tests these build a real DeviceManager, so they touch the backend - but
 // they never ask for a device that has to exist, which makes them safe on a headless
 // CI runner with no audio hardware at all. That is the case they are here for.
+// Those that need a running stream open it on miniaudio's null backend, a timer
+// thread standing in for a device, which every build has unless MA_NO_NULL takes it
+// out.
 
 #include <MakeASound/MakeASound.h>
 
 #include <NanoTest/NanoTest.h>
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
 using namespace nano;
+using MakeASound::AudioCallbackInfo;
 using MakeASound::DeviceManager;
 using MakeASound::Error;
 using MakeASound::StreamConfig;
 
 namespace
 {
+// No test run leaves a backend cache in the home directory of whoever ran it.
+const auto noBackendCache = []
+{
+    DeviceManager::setCacheDirectory("");
+    return true;
+}();
+
+// Switches to the null backend and describes a stereo stream on its output, which
+// reports no channel count of its own.
+StreamConfig makeNullConfig(DeviceManager& manager)
+{
+    check(manager.setBackend(MakeASound::Backend::Null) == Error::NoError);
+
+    auto output = manager.getDefaultOutputDevice();
+    output.outputChannels = 2;
+
+    auto config = StreamConfig {};
+    config.output = MakeASound::StreamParameters(output, false, 2);
+    config.sampleRate = 48000;
+    config.maxBlockSize = 256;
+
+    return config;
+}
+
+// Polls for up to five seconds: the null device calls back on a timer.
+template <typename Fn>
+bool waitUntil(Fn&& done)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+
+    while (!done())
+    {
+        if (std::chrono::steady_clock::now() > deadline)
+            return false;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    return true;
+}
+
+// What the first blocks of a callback saw, written from the audio thread.
+struct BlockLog
+{
+    static constexpr auto size = 32;
+
+    void record(const AudioCallbackInfo& info)
+    {
+        auto at = count.load();
+
+        if (at == size)
+            return;
+
+        dirty[at] = info.dirty;
+        generation[at] = info.generation;
+        count = at + 1;
+    }
+
+    bool isFull() const { return count.load() == size; }
+
+    std::atomic<int> count {0};
+    std::array<std::atomic<bool>, size> dirty {};
+    std::array<std::atomic<std::uint64_t>, size> generation {};
+};
+
 auto tEmptyConfig =
     test("DeviceManager/reportsAStreamWithNoDeviceInsteadOfThrowing") = []
 {
@@ -38,6 +114,21 @@ auto tNoCallback = test("DeviceManager/refusesToOpenAStreamWithNoCallback") = []
     check(!manager.isRunning());
 };
 
+auto tSwapCallback = test("DeviceManager/takesACallbackWithoutAStream") = []
+{
+    // Installing a callback touches no device, so it works on any machine; a later
+    // open then has one and gets past the INVALID_USE check. Clearing it again puts
+    // the manager back where it started.
+    auto manager = DeviceManager {};
+
+    manager.setCallback([](auto&) {});
+    check(manager.setConfig(StreamConfig {}) != Error::INVALID_USE);
+
+    manager.setCallback(nullptr);
+    check(manager.setConfig(StreamConfig {}) == Error::INVALID_USE);
+    check(!manager.isRunning());
+};
+
 auto tDefaultConfig = test("DeviceManager/onlyFillsInSidesThatExist") = []
 {
     // Whatever this machine has. A side that is present has to name a device with
@@ -106,4 +197,198 @@ auto tStopsCleanly = test("DeviceManager/stopsCleanlyAfterAFailedOpen") = []
     check(manager.getStreamSampleRate() == 0);
     check(manager.getStreamLatency() == 0);
 };
+
+auto tDeviceVersion = test("DeviceManager/movesTheDeviceVersionWithTheBackend") = []
+{
+#ifdef MA_NO_NULL
+    return;
+#endif
+
+    // A host polls the version to decide when to rebuild its device menu. Another
+    // driver's list is a change, however many devices either has.
+    auto manager = DeviceManager {};
+
+    manager.getDevices();
+    auto version = manager.getDevicesVersion();
+
+    check(manager.setBackend(MakeASound::Backend::Null) == Error::NoError);
+
+    check(version > 0);
+    check(manager.getDevicesVersion() > version);
+    check(!manager.getDevices().empty());
+};
+
+auto tDeviceIds = test("DeviceManager/givesEveryDeviceItsOwnNonZeroId") = []
+{
+#ifdef MA_NO_NULL
+    return;
+#endif
+
+    // Ids are hashed from the driver's device id and name, so two of them can
+    // collide; the manager must still hand out distinct ones, and never 0, which
+    // hosts use for "no device". The null backend gives its playback and capture
+    // devices the same driver id, so only their names tell them apart.
+    auto listIds = []
+    {
+        auto manager = DeviceManager {};
+        check(manager.setBackend(MakeASound::Backend::Null) == Error::NoError);
+
+        auto ids = std::vector<int> {};
+
+        for (const auto& device: manager.getDevices())
+            ids.push_back(device.id);
+
+        return ids;
+    };
+
+    auto ids = listIds();
+    check(ids.size() >= 2);
+
+    for (auto i = 0; i < static_cast<int>(ids.size()); ++i)
+    {
+        check(ids[i] != 0);
+
+        for (auto j = i + 1; j < static_cast<int>(ids.size()); ++j)
+            check(ids[i] != ids[j]);
+    }
+
+    // Hashed, not counted out: a list enumerated afresh, once every manager that
+    // shared the last one is gone, gives the same devices the same ids.
+    check(listIds() == ids);
+};
+
+auto tSharedContext = test("DeviceManager/sharesOneDeviceListAcrossManagers") = []
+{
+    // Managers on the same backend share a context and its enumeration, so a second
+    // one sees the very list - same ids, same version - without enumerating again.
+    auto first = DeviceManager {};
+    auto second = DeviceManager {};
+
+    auto firstDevices = first.getDevices();
+    auto secondDevices = second.getDevices();
+
+    check(first.getBackend() == second.getBackend());
+    check(first.getDevicesVersion() == second.getDevicesVersion());
+    check(firstDevices.size() == secondDevices.size());
+
+    for (auto i = 0; i < static_cast<int>(firstDevices.size())
+                     && i < static_cast<int>(secondDevices.size());
+         ++i)
+        check(firstDevices[i].id == secondDevices[i].id);
+};
+
+auto tLiveSlice = test("DeviceManager/movesTheChannelSliceWithoutReopening") = []
+{
+#ifdef MA_NO_NULL
+    return;
+#endif
+
+    // Narrowing the output to one channel is a slice change the open device can
+    // take: the stream never stops, and the first block with the new width says so.
+    // A re-open would show twice over - the stream clock starting again from 0, and
+    // another Started from the new device.
+
+    // Declared before the manager, which calls into them until it is gone.
+    auto outputs = std::atomic<int> {-1};
+    auto dirtyAtChange = std::atomic<bool> {false};
+    auto lastStreamTime = std::atomic<double> {-1.0};
+    auto clockWentBack = std::atomic<bool> {false};
+    auto starts = std::atomic<int> {0};
+
+    auto manager = DeviceManager {};
+    auto config = makeNullConfig(manager);
+
+    manager.setNotificationCallback(
+        [&](MakeASound::DeviceNotification notification)
+        {
+            if (notification == MakeASound::DeviceNotification::Started)
+                ++starts;
+        });
+
+    auto result = manager.start(config,
+                                [&](AudioCallbackInfo& info)
+                                {
+                                    if (info.numOutputs == 1 && outputs.load() != 1)
+                                        dirtyAtChange = info.dirty;
+
+                                    if (info.streamTime < lastStreamTime.load())
+                                        clockWentBack = true;
+
+                                    lastStreamTime = info.streamTime;
+                                    outputs = info.numOutputs;
+                                });
+
+    check(result == Error::NoError);
+    check(waitUntil([&] { return outputs.load() == 2 && starts.load() > 0; }));
+
+    auto startsBefore = starts.load();
+
+    config.output->nChannels = 1;
+    check(manager.setConfig(config) == Error::NoError);
+    check(manager.isRunning());
+    check(waitUntil([&] { return outputs.load() == 1; }));
+
+    // A block or two on the new width, for a late Started to have arrived by.
+    auto changedAt = lastStreamTime.load();
+    check(waitUntil([&] { return lastStreamTime.load() > changedAt + 0.01; }));
+
+    check(dirtyAtChange.load());
+    check(!clockWentBack.load());
+    check(starts.load() == startsBefore);
+
+    manager.stop();
+};
+
+auto tDirty = test("DeviceManager/marksTheFirstBlockOfEachGenerationDirty") = []
+{
+#ifdef MA_NO_NULL
+    return;
+#endif
+
+    // Declared before the manager, which calls into them until it is gone.
+    auto first = BlockLog {};
+    auto swapped = BlockLog {};
+    auto reopened = BlockLog {};
+    auto target = std::atomic<BlockLog*> {&swapped};
+
+    auto manager = DeviceManager {};
+    auto config = makeNullConfig(manager);
+
+    check(manager.start(config, [&](auto& info) { first.record(info); })
+          == Error::NoError);
+    check(waitUntil([&] { return first.isFull(); }));
+
+    // The first block is dirty, and once the start's own notification has landed
+    // the rest are clean and share one generation.
+    check(first.dirty[0].load());
+
+    for (auto i = BlockLog::size / 2; i < BlockLog::size; ++i)
+    {
+        check(!first.dirty[i].load());
+        check(first.generation[i].load() == first.generation.back().load());
+    }
+
+    // A new callback has cached nothing, so its first block is dirty too, though
+    // the stream and its generation are the same.
+    manager.setCallback([&](auto& info) { target.load()->record(info); });
+    check(waitUntil([&] { return swapped.isFull(); }));
+
+    check(swapped.dirty[0].load());
+    check(!swapped.dirty.back().load());
+    check(swapped.generation[0].load() == first.generation.back().load());
+
+    // Another backend is another route. The callback stays, so only the new
+    // generation can mark its next block dirty.
+    config = makeNullConfig(manager);
+    target = &reopened;
+
+    check(manager.setConfig(config) == Error::NoError);
+    check(waitUntil([&] { return reopened.isFull(); }));
+
+    check(reopened.dirty[0].load());
+    check(reopened.generation[0].load() > swapped.generation.back().load());
+    check(!reopened.dirty.back().load());
+
+    manager.stop();
+};
 } // namespace
@@ -0,0 +1,161 @@
+// Tests for the adapter behind Flags::fixedBlockSize. The contract a host builds an
+// FFT on: every block is exactly the block size, whatever period sequence the device
+// delivers, and the audio comes out the other side intact, delayed by exactly the
+// latency the adapter reports - no frame dropped, repeated or reordered.
+
+#include <MakeASound/Audio/FixedBlockAdapter.h>
+
+#include <NanoTest/NanoTest.h>
+
+#include <vector>
+
+using namespace nano;
+using MakeASound::FixedBlockAdapter;
+
+namespace
+{
+// Irregular on purpose: shorter than a block, equal, longer, several blocks long,
+// and empty - the shapes Pulse and JACK hand over between them.
+constexpr int periods[] = {37, 64, 1, 200, 0, 63, 65, 128, 7, 300, 19};
+
+constexpr auto channels = 2;
+
+// The value of channel `channel` at absolute frame `frame`, distinct everywhere.
+float sampleAt(int frame, int channel)
+{
+    return static_cast<float>(frame * channels + channel + 1);
+}
+
+// Runs the period sequence through an adapter whose block copies input to output,
+// and reports whether every block had exactly blockSize frames and the output is the
+// input delayed by the reported latency.
+bool passesThroughDelayed(int blockSize)
+{
+    auto adapter = FixedBlockAdapter {};
+    adapter.prepare(channels, channels, blockSize);
+
+    auto exactBlocks = true;
+    auto blocks = 0;
+    auto frame = 0;
+    auto delayedCorrectly = true;
+
+    for (auto period: periods)
+    {
+        auto input = std::vector<float>(static_cast<std::size_t>(period * channels));
+        auto output = std::vector<float>(input.size(), -1.0f);
+
+        for (auto i = 0; i < period; ++i)
+            for (auto ch = 0; ch < channels; ++ch)
+                input[static_cast<std::size_t>(i * channels + ch)] =
+                    sampleAt(frame + i, ch);
+
+        adapter.process(input.data(),
+                        output.data(),
+                        period,
+                        [&](const float* in, float* out)
+                        {
+                            for (auto i = 0; i < blockSize * channels; ++i)
+                            {
+                                // Out arrives silent.
+                                exactBlocks = exactBlocks && out[i] == 0.0f;
+                                out[i] = in[i];
+                            }
+
+                            ++blocks;
+                        });
+
+        for (auto i = 0; i < period; ++i)
+        {
+            auto source = frame + i - adapter.getLatency();
+
+            for (auto ch = 0; ch < channels; ++ch)
+            {
+                auto expected = source < 0 ? 0.0f : sampleAt(source, ch);
+                auto at = static_cast<std::size_t>(i * channels + ch);
+                delayedCorrectly = delayedCorrectly && output[at] == expected;
+            }
+        }
+
+        frame += period;
+    }
+
+    return exactBlocks && delayedCorrectly && blocks == frame / blockSize;
+}
+
+auto tPassThrough =
+    test("FixedBlockAdapter/deliversEveryFrameDelayedByItsLatency") = []
+{
+    check(passesThroughDelayed(64));
+    check(passesThroughDelayed(1));
+    check(passesThroughDelayed(48));
+    check(passesThroughDelayed(512));
+};
+
+auto tLatency = test("FixedBlockAdapter/reportsOneFrameShortOfABlock") = []
+{
+    auto adapter = FixedBlockAdapter {};
+    adapter.prepare(2, 2, 256);
+
+    check(adapter.getBlockSize() == 256);
+    check(adapter.getLatency() == 255);
+};
+
+auto tOneSided = test("FixedBlockAdapter/keepsTimeWithOnlyOneSide") = []
+{
+    // A playback-only stream has no input to count blocks by, and a capture-only one
+    // has no output to fill; both still get a block for every blockSize frames.
+    auto playback = FixedBlockAdapter {};
+    playback.prepare(0, 2, 32);
+
+    auto capture = FixedBlockAdapter {};
+    capture.prepare(2, 0, 32);
+
+    auto playbackBlocks = 0;
+    auto captureBlocks = 0;
+    auto output = std::vector<float>(100 * 2);
+    auto input = std::vector<float>(100 * 2, 0.5f);
+
+    playback.process(nullptr,
+                     output.data(),
+                     100,
+                     [&](const float*, float* out)
+                     {
+                         out[0] = 1.0f;
+                         ++playbackBlocks;
+                     });
+
+    capture.process(input.data(),
+                    nullptr,
+                    100,
+                    [&](const float* in, float*)
+                    { captureBlocks += in[0] == 0.5f ? 1 : 0; });
+
+    check(playbackBlocks == 3);
+    check(captureBlocks == 3);
+
+    // The first block's first frame lands after the priming silence.
+    check(output[static_cast<std::size_t>(playback.getLatency() * 2)] == 1.0f);
+};
+
+auto tReset = test("FixedBlockAdapter/resetDropsWhatWasQueued") = []
+{
+    auto adapter = FixedBlockAdapter {};
+    adapter.prepare(1, 1, 8);
+
+    auto input = std::vector<float>(5, 1.0f);
+    auto output = std::vector<float>(5);
+    auto blocks = 0;
+    auto count = [&](const float*, float*) { ++blocks; };
+
+    adapter.process(input.data(), output.data(), 5, count);
+    adapter.reset();
+
+    // Five more would make a block with the five before the reset; after it, they
+    // are gone and it takes eight.
+    adapter.process(input.data(), output.data(), 5, count);
+    check(blocks == 0);
+
+    adapter.process(input.data(), output.data(), 3, count);
+    check(blocks == 1);
+};
+} // namespace
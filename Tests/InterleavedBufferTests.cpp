@@ -0,0 +1,107 @@
+// Tests for MakeASound::InterleavedView - the strided view an interleaved stream's
+// callback gets over the device's own frames. What's worth pinning is the stride
+// arithmetic: a view over a slice of each frame has to step by the device's width,
+// not its own channel count, or every sample after the first frame is wrong.
+
+#include <MakeASound/Audio/InterleavedBuffer.h>
+
+#include <NanoTest/NanoTest.h>
+
+#include <array>
+#include <vector>
+
+using namespace nano;
+using MakeASound::InterleavedBuffer;
+using MakeASound::InterleavedView;
+
+namespace
+{
+constexpr auto deviceChannels = 4;
+constexpr auto numFrames = 3;
+
+// A 4-channel, 3-frame interleaved block where frame f, channel c holds f * 10 + c.
+struct InterleavedBlock
+{
+    InterleavedBlock() noexcept
+    {
+        for (auto frame = 0; frame < numFrames; ++frame)
+            for (auto channel = 0; channel < deviceChannels; ++channel)
+                samples[frame * deviceChannels + channel] =
+                    static_cast<float>(frame * 10 + channel);
+    }
+
+    // Channels [first, first + count) of every frame.
+    InterleavedBuffer view(int first, int count) noexcept
+    {
+        return {samples.data() + first, count, numFrames, deviceChannels};
+    }
+
+    std::array<float, deviceChannels * numFrames> samples {};
+};
+
+auto tShape = test("InterleavedBuffer/reportsItsShape") = []
+{
+    auto block = InterleavedBlock {};
+    auto view = block.view(0, deviceChannels);
+
+    check(view.getNumChannels() == deviceChannels);
+    check(view.getNumSamples() == numFrames);
+    check(view.getStride() == deviceChannels);
+    check(!view.isEmpty());
+    check(InterleavedBuffer {}.isEmpty());
+};
+
+auto tSlice = test("InterleavedBuffer/aSliceStepsByTheDeviceWidth") = []
+{
+    // Channels 1 and 2 of the device.
+    auto block = InterleavedBlock {};
+    auto view = block.view(1, 2);
+
+    check(view.getSample(0, 0) == 1.0f);
+    check(view.getSample(1, 2) == 22.0f);
+    check(view.getFrame(1)[0] == 11.0f);
+    check(view.getFrame(1)[1] == 12.0f);
+};
+
+auto tChannel = test("InterleavedBuffer/iteratesAChannelAcrossFrames") = []
+{
+    auto block = InterleavedBlock {};
+    auto view = block.view(0, deviceChannels);
+
+    auto seen = std::vector<float> {};
+
+    for (auto sample: view.getChannel(3))
+        seen.push_back(sample);
+
+    check(seen.size() == numFrames);
+    check(seen[0] == 3.0f);
+    check(seen[1] == 13.0f);
+    check(seen[2] == 23.0f);
+    check(view.getChannel(3).size() == numFrames);
+};
+
+auto tWrites = test("InterleavedBuffer/writesLandInTheFramesAndNowhereElse") = []
+{
+    auto block = InterleavedBlock {};
+    auto view = block.view(2, 1);
+
+    for (auto& sample: view.getChannel(0))
+        sample = -1.0f;
+
+    for (auto frame = 0; frame < numFrames; ++frame)
+    {
+        check(block.samples[frame * deviceChannels + 2] == -1.0f);
+        check(block.samples[frame * deviceChannels + 1]
+              == static_cast<float>(frame * 10 + 1));
+    }
+};
+
+auto tConst = test("InterleavedBuffer/readsThroughAConstView") = []
+{
+    const auto block = InterleavedBlock {};
+    auto view = InterleavedView<const float> {
+        block.samples.data(), deviceChannels, numFrames, deviceChannels};
+
+    check(view.getSample(2, 1) == 12.0f);
+};
+} // namespace
@@ -0,0 +1,131 @@
+// Tests for MakeASound::MPSCQueue - the bounded queue many threads push to and one
+// pops from. The single-threaded cases pin FIFO order, full / empty and the wrap;
+// the concurrent case runs several real producers against a real consumer and
+// proves every element crosses intact and exactly once, with each producer's
+// elements still in the order that producer pushed them.
+
+#include <MakeASound/Realtime/MPSCQueue.h>
+
+#include <NanoTest/NanoTest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace nano;
+using MakeASound::MPSCQueue;
+
+namespace
+{
+// tag == derive(producer, seq), so a torn element shows as well as a lost one.
+struct Message
+{
+    int producer = 0;
+    int seq = 0;
+    int tag = 0;
+};
+
+int derive(int producer, int seq) noexcept
+{
+    return producer * 1'000'003 + seq * 7 + 1;
+}
+
+auto tFifo = test("MPSCQueue/deliversInFifoOrder") = []
+{
+    auto queue = MPSCQueue<int, 8> {};
+
+    check(queue.push(1));
+    check(queue.push(2));
+    check(queue.push(3));
+    check(queue.sizeApprox() == 3);
+
+    auto value = 0;
+    check(queue.pop(value) && value == 1);
+    check(queue.pop(value) && value == 2);
+    check(queue.pop(value) && value == 3);
+    check(!queue.pop(value) && value == 3);
+};
+
+auto tFull = test("MPSCQueue/usesEverySlotThenRefuses") = []
+{
+    auto queue = MPSCQueue<int, 4> {};
+
+    for (auto i = 0; i < 4; ++i)
+        check(queue.push(i));
+
+    check(!queue.push(4));
+
+    auto value = -1;
+    check(queue.pop(value) && value == 0);
+    check(queue.push(4));
+    check(!queue.push(5));
+};
+
+auto tWraps = test("MPSCQueue/wrapsAroundTheRing") = []
+{
+    auto queue = MPSCQueue<int, 4> {};
+    auto next = 0;
+    auto expected = 0;
+    auto ok = true;
+
+    for (auto lap = 0; lap < 1000; ++lap)
+    {
+        auto count = lap % 4 + 1;
+
+        for (auto i = 0; i < count; ++i)
+            ok = ok && queue.push(next++);
+
+        auto value = 0;
+
+        for (auto i = 0; i < count; ++i)
+            ok = ok && queue.pop(value) && value == expected++;
+    }
+
+    check(ok);
+    check(queue.sizeApprox() == 0);
+};
+
+auto tConcurrent =
+    test("MPSCQueue/concurrentProducersDeliverEverythingInPerProducerOrder") = []
+{
+    constexpr auto producers = 4;
+    constexpr auto perProducer = 50'000;
+
+    auto queue = MPSCQueue<Message, 64> {};
+    auto threads = std::vector<std::thread> {};
+
+    for (auto p = 0; p < producers; ++p)
+        threads.emplace_back(
+            [&queue, p]
+            {
+                for (auto i = 0; i < perProducer; ++i)
+                    while (!queue.push({p, i, derive(p, i)}))
+                        std::this_thread::yield(); // full - let the consumer run
+            });
+
+    auto next = std::vector<int>(producers, 0);
+    auto ok = true;
+    auto message = Message {};
+
+    for (auto received = 0; received < producers * perProducer;)
+    {
+        if (!queue.pop(message))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        auto& expected = next[static_cast<std::size_t>(message.producer)];
+        ok = ok && message.seq == expected
+             && message.tag == derive(message.producer, message.seq);
+        ++expected;
+        ++received;
+    }
+
+    for (auto& thread: threads)
+        thread.join();
+
+    check(ok);
+    check(queue.sizeApprox() == 0);
+};
+} // namespace
@@ -0,0 +1,141 @@
+// Tests for processBlockWithMidi - the sub-block driver a host renders MIDI-driven
+// blocks through. The cases pin the tiling: the slices cover the block exactly, with
+// no sample rendered twice or skipped; every event is delivered once, in order, at
+// the slice boundary closest to its own offset; and the minimum slice length holds
+// however dense the controller stream gets.
+
+#include <MakeASound/MIDI/MidiBlockSync.h>
+
+#include <NanoTest/NanoTest.h>
+
+#include <vector>
+
+using namespace nano;
+using MakeASound::processBlockWithMidi;
+namespace MIDI = MakeASound::MIDI;
+
+namespace
+{
+struct Slice
+{
+    int start = 0;
+    int end = 0;
+};
+
+// What the driver did, in order: each slice rendered, and the boundary every event
+// was applied at.
+struct Trace
+{
+    std::vector<Slice> slices;
+    std::vector<int> appliedAt;
+    std::vector<int> controllers;
+};
+
+Trace run(const MIDI::Buffer& events, int numSamples, int minSubBlockSize)
+{
+    auto trace = Trace {};
+
+    processBlockWithMidi(
+        events,
+        numSamples,
+        minSubBlockSize,
+        [&](int start, int end) { trace.slices.push_back({start, end}); },
+        [&](const MIDI::Event& event)
+        {
+            auto boundary = trace.slices.empty() ? 0 : trace.slices.back().end;
+            trace.appliedAt.push_back(boundary);
+            trace.controllers.push_back(event.asControlChange()->controller);
+        });
+
+    return trace;
+}
+
+// One controller event per entry, numbered in order so delivery order shows.
+MIDI::Buffer makeEvents(std::initializer_list<int> offsets)
+{
+    auto events = MIDI::Buffer {};
+    auto index = 0;
+
+    for (auto offset: offsets)
+        events.add(MIDI::Event::controlChange(0, index++, 0.5f, offset));
+
+    return events;
+}
+
+bool tilesTheBlock(const Trace& trace, int numSamples)
+{
+    auto cursor = 0;
+
+    for (const auto& slice: trace.slices)
+    {
+        if (slice.start != cursor || slice.end <= slice.start)
+            return false;
+
+        cursor = slice.end;
+    }
+
+    return cursor == numSamples;
+}
+
+auto tSplits = test("MidiBlockSplit/cutsAtEachEventOffset") = []
+{
+    auto trace = run(makeEvents({0, 10, 10, 100}), 128, 1);
+
+    check(tilesTheBlock(trace, 128));
+    check(trace.slices.size() == 3);
+    check(trace.appliedAt == std::vector<int> {0, 10, 10, 100});
+    check(trace.controllers == std::vector<int> {0, 1, 2, 3});
+};
+
+auto tNoEvents = test("MidiBlockSplit/rendersAWholeBlockWithNoEvents") = []
+{
+    auto trace = run(MIDI::Buffer {}, 64, 1);
+
+    check(trace.slices.size() == 1);
+    check(tilesTheBlock(trace, 64));
+};
+
+auto tMinimum = test("MidiBlockSplit/neverCutsCloserThanTheMinimum") = []
+{
+    // A controller on every sample: at a 16-sample minimum that is eight slices, not
+    // 128, and each event applies at the cut at or before its own offset.
+    auto events = MIDI::Buffer {};
+
+    for (auto offset = 0; offset < 128; ++offset)
+        events.add(MIDI::Event::controlChange(0, offset, 0.5f, offset));
+
+    auto trace = run(events, 128, 16);
+
+    check(tilesTheBlock(trace, 128));
+    check(trace.slices.size() == 8);
+
+    auto ok = true;
+
+    for (auto i = 0; i + 1 < static_cast<int>(trace.slices.size()); ++i)
+        ok = ok && trace.slices[i].end - trace.slices[i].start >= 16;
+
+    for (auto i = 0; i < 128; ++i)
+        ok = ok && trace.appliedAt[i] <= i && i - trace.appliedAt[i] < 16;
+
+    check(ok);
+    check(trace.controllers.size() == 128);
+};
+
+auto tOutOfRange = test("MidiBlockSplit/clampsEventsItCannotPlace") = []
+{
+    // Past the end applies after the last slice; before the cursor - out of order -
+    // applies at the cursor rather than rendering backwards.
+    auto trace = run(makeEvents({50, 20, 500}), 64, 1);
+
+    check(tilesTheBlock(trace, 64));
+    check(trace.appliedAt == std::vector<int> {50, 50, 64});
+};
+
+auto tEmptyBlock = test("MidiBlockSplit/deliversEventsForAnEmptyBlock") = []
+{
+    auto trace = run(makeEvents({0, 3}), 0, 1);
+
+    check(trace.slices.empty());
+    check(trace.controllers.size() == 2);
+};
+} // namespace
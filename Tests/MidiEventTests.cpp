@@ -0,0 +1,107 @@
+// Tests for MakeASound::MIDI::Event's packed representation. The cases pin what the
+// packing must not change: each factory's fields come back exactly through the typed
+// views and through visit, an event survives the trip to MIDI 1.0 bytes and back,
+// and SysEx is rebuilt with the framing it arrived with.
+
+#include <MakeASound/MIDI/MIDI.h>
+
+#include <NanoTest/NanoTest.h>
+
+#include <string>
+#include <type_traits>
+
+using namespace nano;
+namespace MIDI = MakeASound::MIDI;
+
+namespace
+{
+// Decoding is constexpr, so the layout can be checked without running anything.
+static_assert(sizeof(MIDI::Event) == 12);
+static_assert(std::is_trivially_copyable_v<MIDI::Event>);
+static_assert(MIDI::Event::noteOn(5, 60, 0.5f).asNoteOn()->pitch == 60);
+static_assert(MIDI::Event::noteOn(5, 60, 0.5f).getChannel() == 5);
+static_assert(!MIDI::Event::noteOn(5, 60, 0.5f).asNoteOff());
+
+auto tFields = test("MidiEvent/viewsReturnExactlyWhatWasStored") = []
+{
+    auto note = MIDI::Event::noteOn(3, 64, 0.123456f, 17);
+    check(note.isNoteOn() && note.getChannel() == 3 && note.sampleOffset == 17);
+    check(note.asNoteOn()->pitch == 64);
+    check(note.asNoteOn()->velocity == 0.123456f);
+
+    auto cc = MIDI::Event::controlChange(15, 74, 0.999f);
+    check(cc.isControlChange() && cc.getChannel() == 15);
+    check(cc.asControlChange()->controller == 74);
+    check(cc.asControlChange()->value == 0.999f);
+
+    auto bend = MIDI::Event::pitchBend(0, -0.75f);
+    check(bend.isPitchBend() && bend.asPitchBend()->value == -0.75f);
+
+    auto poly = MIDI::Event::polyAftertouch(9, 36, 0.25f);
+    check(poly.asPolyAftertouch()->pitch == 36);
+    check(poly.asPolyAftertouch()->pressure == 0.25f);
+
+    auto program = MIDI::Event::programChange(1, 127);
+    check(program.asProgramChange()->program == 127);
+    check(!program.asControlChange() && !program.isSysEx());
+};
+
+auto tVisit = test("MidiEvent/visitDispatchesOnTheKind") = []
+{
+    auto describe = [](const MIDI::Event& event)
+    {
+        return event.visit(MIDI::overloaded {
+            [](const MIDI::NoteOff& n) { return "off " + std::to_string(n.pitch); },
+            [](const MIDI::ChannelAftertouch&) { return std::string {"pressure"}; },
+            [](const auto&) { return std::string {"other"}; },
+        });
+    };
+
+    check(describe(MIDI::Event::noteOff(0, 42, 0.0f)) == "off 42");
+    check(describe(MIDI::Event::channelAftertouch(0, 0.5f)) == "pressure");
+    check(describe(MIDI::Event::noteOn(0, 42, 0.5f)) == "other");
+};
+
+auto tBytes = test("MidiEvent/roundTripsThroughMidiBytes") = []
+{
+    const std::uint8_t messages[][3] = {{0x93, 60, 100},
+                                        {0x80, 61, 0},
+                                        {0xB2, 7, 127},
+                                        {0xEF, 0x00, 0x40},
+                                        {0xA4, 36, 1}};
+
+    for (const auto& bytes: messages)
+    {
+        auto event = MIDI::convertMidi(bytes, 3);
+        check(event.has_value());
+
+        auto raw = MIDI::toBytes(*event);
+        check(raw.size == 3);
+        check(raw.data[0] == bytes[0]);
+        check(raw.data[1] == bytes[1]);
+        check(raw.data[2] == bytes[2]);
+    }
+};
+
+auto tSysEx = test("MidiEvent/sysExKeepsItsFraming") = []
+{
+    const std::uint8_t gmReset[] = {0xF0, 0x7E, 0x7F, 0x09, 0x01, 0xF7};
+
+    auto framed = MIDI::Event::sysEx(gmReset, 6, 9);
+    check(framed.isSysEx() && framed.getChannel() == -1 && framed.sampleOffset == 9);
+
+    auto sysEx = *framed.asSysEx();
+    check(sysEx.size == 6);
+
+    for (auto i = 0; i < 6; ++i)
+        check(sysEx.data[static_cast<std::size_t>(i)] == gmReset[i]);
+
+    // A bare payload comes back bare, all six bytes of it.
+    const std::uint8_t payload[] = {1, 2, 3, 4, 5, 6};
+    auto raw = MIDI::toBytes(MIDI::Event::sysEx(payload, 6));
+    check(raw.size == 6);
+
+    for (auto i = 0; i < 6; ++i)
+        check(raw.data[static_cast<std::size_t>(i)] == payload[i]);
+};
+} // namespace
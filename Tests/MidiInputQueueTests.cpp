@@ -0,0 +1,206 @@
+// Tests for MidiInputQueue and MidiInputRotation - how queued MIDI input reaches the
+// audio thread. The cases pin the drain: events come out in arrival order, a cut-off
+// time or a full buffer stops it and leaves the rest queued rather than lost, an
+// overflowing queue drops and counts what doesn't fit, and when the buffer fills
+// across several ports, each call starts at the next one so none is always last.
+
+#include <MakeASound/MIDI/MidiInputQueue.h>
+
+#include <NanoTest/NanoTest.h>
+
+#include <array>
+#include <chrono>
+#include <vector>
+
+using namespace nano;
+using MakeASound::MidiEvents;
+using MakeASound::MidiInputEvent;
+using MakeASound::MidiInputQueue;
+using MakeASound::MidiInputRotation;
+using MakeASound::MidiTimePoint;
+
+namespace
+{
+auto at(int ms)
+{
+    return MidiTimePoint {} + std::chrono::milliseconds(ms);
+}
+
+// Told apart by port, and by a sampleOffset that just counts up per port.
+MidiInputEvent makeEvent(int portId, int value, int ms)
+{
+    auto event = MidiInputEvent {};
+    event.portId = portId;
+    event.event.sampleOffset = value;
+    event.arrival = at(ms);
+    return event;
+}
+
+std::vector<int> valuesOf(const MidiEvents& events)
+{
+    auto values = std::vector<int> {};
+
+    for (const auto& e: events)
+        values.push_back(e.event.sampleOffset);
+
+    return values;
+}
+
+auto tOrder = test("MidiInputQueue/drainsInArrivalOrder") = []
+{
+    auto queue = MidiInputQueue {};
+    auto out = MidiEvents {};
+
+    for (auto i = 0; i < 5; ++i)
+        check(queue.push(makeEvent(0, i, i)));
+
+    check(queue.drainInto(out, MidiTimePoint::max()) == 5);
+    check(valuesOf(out) == std::vector<int> {0, 1, 2, 3, 4});
+    check(queue.drainInto(out, MidiTimePoint::max()) == 0);
+};
+
+auto tUntil = test("MidiInputQueue/leavesWhatArrivedLaterQueued") = []
+{
+    auto queue = MidiInputQueue {};
+    auto out = MidiEvents {};
+
+    for (auto i = 0; i < 6; ++i)
+        queue.push(makeEvent(0, i, i * 10));
+
+    check(queue.drainInto(out, at(20)) == 3);
+    check(valuesOf(out) == std::vector<int> {0, 1, 2});
+
+    out.clear();
+    check(queue.drainInto(out, MidiTimePoint::max()) == 3);
+    check(valuesOf(out) == std::vector<int> {3, 4, 5});
+};
+
+auto tFull = test("MidiInputQueue/stopsAtAFullBufferAndKeepsTheRest") = []
+{
+    auto queue = MidiInputQueue {};
+    auto out = MidiEvents {3};
+
+    for (auto i = 0; i < 5; ++i)
+        queue.push(makeEvent(0, i, i));
+
+    check(queue.drainInto(out, MidiTimePoint::max()) == 3);
+    check(out.isFull());
+    check(queue.drainInto(out, MidiTimePoint::max()) == 0);
+
+    out.clear();
+    check(queue.drainInto(out, MidiTimePoint::max()) == 2);
+    check(valuesOf(out) == std::vector<int> {3, 4});
+    check(queue.getDropped() == 0);
+};
+
+auto tWrap = test("MidiInputQueue/drainsAcrossTheRingsEnd") = []
+{
+    auto queue = MidiInputQueue {};
+    auto out = MidiEvents {static_cast<int>(MidiInputQueue::capacity)};
+    constexpr auto offset = static_cast<int>(MidiInputQueue::capacity) - 3;
+
+    for (auto i = 0; i < offset; ++i)
+        queue.push(makeEvent(0, i, 0));
+
+    queue.drainInto(out, MidiTimePoint::max());
+    out.clear();
+
+    for (auto i = 0; i < 8; ++i)
+        queue.push(makeEvent(0, i, i));
+
+    check(queue.drainInto(out, MidiTimePoint::max()) == 8);
+    check(valuesOf(out) == std::vector<int> {0, 1, 2, 3, 4, 5, 6, 7});
+};
+
+auto tDropped = test("MidiInputQueue/countsWhatOverflowDrops") = []
+{
+    auto queue = MidiInputQueue {};
+    auto pushed = 0;
+
+    for (auto i = 0; i < static_cast<int>(MidiInputQueue::capacity) + 5; ++i)
+        pushed += queue.push(makeEvent(0, i, i)) ? 1 : 0;
+
+    check(pushed == static_cast<int>(MidiInputQueue::capacity));
+    check(queue.getDropped() == 5);
+
+    // What was kept is the oldest, and draining makes room again.
+    auto out = MidiEvents {static_cast<int>(MidiInputQueue::capacity)};
+    check(queue.drainInto(out, MidiTimePoint::max()) == pushed);
+    check(out[0].event.sampleOffset == 0);
+    check(queue.push(makeEvent(0, 0, 0)));
+    check(queue.getDropped() == 5);
+};
+
+auto tRotation = test("MidiInputRotation/startsEachDrainAtTheNextPort") = []
+{
+    auto queues = std::array<MidiInputQueue, 3> {};
+    auto queueAt = [&](int i) { return &queues[i]; };
+
+    for (auto port = 0; port < 3; ++port)
+        for (auto i = 0; i < 4; ++i)
+            queues[port].push(makeEvent(port, i, i));
+
+    // Room for two events a call: only the port drained first gets any.
+    auto rotation = MidiInputRotation {};
+    auto out = MidiEvents {2};
+    auto firstPorts = std::vector<int> {};
+
+    for (auto call = 0; call < 6; ++call)
+    {
+        out.clear();
+        check(rotation.drain(3, queueAt, out, MidiTimePoint::max()) == 2);
+        check(out[0].portId == out[1].portId);
+        firstPorts.push_back(out[0].portId);
+    }
+
+    check(firstPorts == std::vector<int> {0, 1, 2, 0, 1, 2});
+
+    // Six calls of two: every port was emptied, none left behind.
+    for (auto& queue: queues)
+    {
+        out.clear();
+        check(queue.drainInto(out, MidiTimePoint::max()) == 0);
+    }
+};
+
+auto tShared = test("MidiInputRotation/sharesAFullBufferAcrossPorts") = []
+{
+    auto queues = std::array<MidiInputQueue, 2> {};
+    auto queueAt = [&](int i) { return &queues[i]; };
+
+    for (auto port = 0; port < 2; ++port)
+        for (auto i = 0; i < 3; ++i)
+            queues[port].push(makeEvent(port, i, i));
+
+    // Four slots for six events: the first port empties, the second gives one.
+    auto rotation = MidiInputRotation {};
+    auto out = MidiEvents {4};
+
+    check(rotation.drain(2, queueAt, out, MidiTimePoint::max()) == 4);
+    check(out[3].portId == 1 && out[3].event.sampleOffset == 0);
+
+    // The next call starts at the port that was cut short.
+    out.clear();
+    check(rotation.drain(2, queueAt, out, MidiTimePoint::max()) == 2);
+    check(out[0].portId == 1 && out[0].event.sampleOffset == 1);
+    check(out[1].portId == 1 && out[1].event.sampleOffset == 2);
+};
+
+auto tSkip = test("MidiInputRotation/skipsPortsItIsNotGiven") = []
+{
+    auto queues = std::array<MidiInputQueue, 3> {};
+    auto queueAt = [&](int i) { return i == 1 ? nullptr : &queues[i]; };
+
+    for (auto port = 0; port < 3; ++port)
+        queues[port].push(makeEvent(port, 0, 0));
+
+    auto rotation = MidiInputRotation {};
+    auto out = MidiEvents {};
+
+    check(rotation.drain(3, queueAt, out, MidiTimePoint::max()) == 2);
+    check(out[0].portId == 0 && out[1].portId == 2);
+
+    out.clear();
+    check(queues[1].drainInto(out, MidiTimePoint::max()) == 1);
+};
+} // namespace
@@ -0,0 +1,121 @@
+// Tests for MidiOutputScheduler - timed MIDI out from the audio thread. They send
+// through a function that records what the sender thread sends and when, and pin
+// the timing: nothing goes out before its sample's time, latency delays everything
+// alike, events go out in time order whatever order they were scheduled in, and a
+// schedule before any block has begun is dropped rather than given a guessed time.
+
+#include <MakeASound/MIDI/MidiOutputScheduler.h>
+
+#include <NanoTest/NanoTest.h>
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace nano;
+using MakeASound::MidiOutputScheduler;
+namespace MIDI = MakeASound::MIDI;
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+struct Sent
+{
+    int note = 0;
+    Clock::time_point at {};
+};
+
+struct Recorder
+{
+    std::mutex mutex;
+    std::vector<Sent> sent;
+
+    MidiOutputScheduler::SendFn sendFn()
+    {
+        return [this](const MIDI::Event& event)
+        {
+            auto lock = std::lock_guard(mutex);
+            sent.push_back({event.asNoteOn()->pitch, Clock::now()});
+        };
+    }
+
+    std::vector<Sent> waitFor(std::size_t count)
+    {
+        auto deadline = Clock::now() + std::chrono::seconds(5);
+
+        while (Clock::now() < deadline)
+        {
+            {
+                auto lock = std::lock_guard(mutex);
+                if (sent.size() >= count)
+                    return sent;
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        auto lock = std::lock_guard(mutex);
+        return sent;
+    }
+};
+
+MIDI::Event note(int number, int offset)
+{
+    return MIDI::Event::noteOn(0, number, 1.0f, offset);
+}
+
+auto tNeedsBlock = test("MidiOutputScheduler/scheduleBeforeBlockIsDropped") = []
+{
+    auto recorder = Recorder {};
+    auto scheduler = MidiOutputScheduler {recorder.sendFn()};
+
+    check(!scheduler.schedule(note(60, 0)));
+    check(scheduler.getDropped() == 1);
+};
+
+// 1 kHz makes a sample a millisecond: offsets far enough apart to see.
+auto tTimed = test("MidiOutputScheduler/sendsAtSampleTimeInOrder") = []
+{
+    auto recorder = Recorder {};
+    auto scheduler = MidiOutputScheduler {recorder.sendFn()};
+
+    auto begun = Clock::now();
+    scheduler.beginBlock(1000, 0.0);
+
+    check(scheduler.schedule(note(62, 60)));
+    check(scheduler.schedule(note(61, 30)));
+    check(scheduler.schedule(note(60, 0)));
+
+    auto sent = recorder.waitFor(3);
+    check(sent.size() == 3);
+
+    if (sent.size() != 3)
+        return;
+
+    check(sent[0].note == 60);
+    check(sent[1].note == 61);
+    check(sent[2].note == 62);
+
+    check(sent[1].at - begun >= std::chrono::milliseconds(30));
+    check(sent[2].at - begun >= std::chrono::milliseconds(60));
+};
+
+auto tLatency = test("MidiOutputScheduler/latencyDelaysEverything") = []
+{
+    auto recorder = Recorder {};
+    auto scheduler = MidiOutputScheduler {recorder.sendFn()};
+    scheduler.setLatency(40);
+
+    auto begun = Clock::now();
+    scheduler.beginBlock(1000, 0.0);
+    check(scheduler.schedule(note(60, 0)));
+
+    auto sent = recorder.waitFor(1);
+    check(sent.size() == 1);
+
+    if (!sent.empty())
+        check(sent[0].at - begun >= std::chrono::milliseconds(40));
+};
+} // namespace
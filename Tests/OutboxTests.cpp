@@ -0,0 +1,104 @@
+// Tests for MakeASound::Outbox - the audio thread's allocation-free channel to the
+// UI. The cases pin batch delivery in posting order, the coalescing of keyed
+// messages down to the last of each key per drain, and that a full ring refuses
+// and counts rather than blocking; the concurrent case drains from a real UI-side
+// thread while the audio side posts.
+
+#include <MakeASound/Realtime/Outbox.h>
+
+#include <NanoTest/NanoTest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace nano;
+using MakeASound::Outbox;
+
+namespace
+{
+std::vector<int> drainAll(Outbox<int, 16>& outbox)
+{
+    auto received = std::vector<int> {};
+    outbox.drain([&](int value) { received.push_back(value); });
+    return received;
+}
+
+auto tOrder = test("Outbox/deliversUnkeyedMessagesInOrder") = []
+{
+    auto outbox = Outbox<int, 16> {};
+
+    for (auto i = 0; i < 5; ++i)
+        check(outbox.post(i));
+
+    check((drainAll(outbox) == std::vector<int> {0, 1, 2, 3, 4}));
+    check(drainAll(outbox).empty());
+};
+
+auto tCoalesce = test("Outbox/coalescesRepeatedKeysToTheLast") = []
+{
+    auto outbox = Outbox<int, 16> {};
+
+    outbox.post(10, 0);
+    outbox.post(100);
+    outbox.post(11, 0);
+    outbox.post(20, 1);
+    outbox.post(101);
+    outbox.post(12, 0);
+
+    // Key 0's last value, in its own place; key 1's only one; every unkeyed message.
+    check((drainAll(outbox) == std::vector<int> {100, 20, 101, 12}));
+
+    // Coalescing is per drain: the next batch delivers the key again.
+    outbox.post(13, 0);
+    check((drainAll(outbox) == std::vector<int> {13}));
+};
+
+auto tFull = test("Outbox/refusesAndCountsWhenFull") = []
+{
+    auto outbox = Outbox<int, 16> {};
+
+    for (auto i = 0; i < 16; ++i)
+        check(outbox.post(i));
+
+    check(!outbox.post(16));
+    check(!outbox.post(17));
+    check(outbox.getDropped() == 2);
+
+    check(drainAll(outbox).size() == 16);
+    check(outbox.post(18));
+};
+
+auto tConcurrent = test("Outbox/concurrentPostAndDrainLosesNothingUnkeyed") = []
+{
+    constexpr auto total = 100'000;
+
+    auto outbox = Outbox<int, 256> {};
+    std::atomic<bool> done {false};
+
+    auto audio = std::thread(
+        [&]
+        {
+            for (auto i = 0; i < total; ++i)
+                while (!outbox.post(i))
+                    std::this_thread::yield(); // full - let the UI side drain
+
+            done.store(true, std::memory_order_release);
+        });
+
+    auto expected = 0;
+    auto ok = true;
+
+    auto deliver = [&](int value) { ok = ok && value == expected++; };
+
+    while (!done.load(std::memory_order_acquire))
+        if (outbox.drain(deliver) == 0)
+            std::this_thread::yield();
+
+    outbox.drain(deliver);
+    audio.join();
+
+    check(ok);
+    check(expected == total);
+};
+} // namespace
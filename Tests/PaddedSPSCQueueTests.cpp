@@ -0,0 +1,156 @@
+// Tests for MakeASound::PaddedSPSCQueue - SPSCQueue's contract with padded indices,
+// a power-of-two ring and cached opposite indices. The single-threaded cases pin
+// what differs from SPSCQueue: every slot is usable, and the free-running indices
+// wrap by mask. The concurrent cases are what the cached indices have to survive: a
+// stale copy must only ever make a side think there is less room (or less data) than
+// there is, never more.
+
+#include <MakeASound/Realtime/PaddedSPSCQueue.h>
+
+#include <NanoTest/NanoTest.h>
+
+#include <atomic>
+#include <thread>
+
+using namespace nano;
+using MakeASound::PaddedSPSCQueue;
+
+namespace
+{
+// tag == seq * 3 + 7, so a torn or half-published element shows as well as a lost
+// or reordered one.
+struct Message
+{
+    int seq = 0;
+    int tag = 0;
+};
+
+Message makeMessage(int seq) noexcept
+{
+    return {seq, seq * 3 + 7};
+}
+
+// One producer (this thread) and one consumer pushing `total` messages through a
+// queue of Capacity slots; true if all arrived intact, once each and in order.
+template <std::size_t Capacity>
+bool transfersInOrder(int total)
+{
+    auto queue = PaddedSPSCQueue<Message, Capacity> {};
+    std::atomic<bool> ok {true};
+    std::atomic<int> receivedCount {0};
+
+    auto consumer = std::thread(
+        [&]
+        {
+            auto expected = 0;
+            auto item = Message {};
+
+            while (expected < total)
+            {
+                if (queue.pop(item))
+                {
+                    if (item.seq != expected
+                        || item.tag != makeMessage(expected).tag)
+                        ok.store(false, std::memory_order_relaxed);
+
+                    ++expected;
+                }
+                else
+                {
+                    std::this_thread::yield(); // empty - let the producer run
+                }
+            }
+
+            receivedCount.store(expected, std::memory_order_relaxed);
+        });
+
+    for (auto i = 0; i < total; ++i)
+        while (!queue.push(makeMessage(i)))
+            std::this_thread::yield(); // full - let the consumer free a slot
+
+    consumer.join();
+
+    return ok.load(std::memory_order_relaxed)
+           && receivedCount.load(std::memory_order_relaxed) == total;
+}
+
+auto tFifo = test("PaddedSPSCQueue/deliversInFifoOrder") = []
+{
+    auto queue = PaddedSPSCQueue<int, 8> {};
+
+    check(queue.push(10));
+    check(queue.push(20));
+    check(queue.push(30));
+    check(queue.sizeApprox() == 3);
+
+    auto value = 0;
+    check(queue.pop(value) && value == 10);
+    check(queue.pop(value) && value == 20);
+    check(queue.pop(value) && value == 30);
+    check(!queue.pop(value) && value == 30);
+};
+
+auto tEverySlot = test("PaddedSPSCQueue/usesEverySlot") = []
+{
+    // No slot held back: a capacity of four holds four, where SPSCQueue<int, 4>
+    // holds three.
+    auto queue = PaddedSPSCQueue<int, 4> {};
+
+    for (auto i = 0; i < 4; ++i)
+        check(queue.push(i));
+
+    check(!queue.push(4));
+    check(queue.sizeApprox() == 4);
+
+    auto value = -1;
+    check(queue.pop(value) && value == 0);
+    check(queue.push(4));
+    check(!queue.push(5));
+};
+
+auto tWraps = test("PaddedSPSCQueue/wrapsAroundTheRing") = []
+{
+    // Many laps at every fill level, so the mask is exercised from every slot and
+    // the cached indices go stale both ways.
+    auto queue = PaddedSPSCQueue<int, 4> {};
+    auto next = 0;
+    auto expected = 0;
+    auto ok = true;
+
+    for (auto lap = 0; lap < 1000; ++lap)
+    {
+        auto count = lap % 4 + 1;
+
+        for (auto i = 0; i < count; ++i)
+            ok = ok && queue.push(next++);
+
+        auto value = 0;
+
+        for (auto i = 0; i < count; ++i)
+            ok = ok && queue.pop(value) && value == expected++;
+    }
+
+    check(ok);
+    check(queue.sizeApprox() == 0);
+};
+
+auto tPadded = test("PaddedSPSCQueue/keepsTheIndicesOnTheirOwnCacheLines") = []
+{
+    check(alignof(PaddedSPSCQueue<char, 2>) >= MakeASound::cacheLineSize);
+    check(sizeof(PaddedSPSCQueue<char, 2>) >= 3 * MakeASound::cacheLineSize);
+};
+
+auto tConcurrent =
+    test("PaddedSPSCQueue/concurrentProducerConsumerDeliversEverythingInOrder") = []
+{
+    check(transfersInOrder<1024>(1'000'000));
+};
+
+auto tConcurrentTiny =
+    test("PaddedSPSCQueue/concurrentWithCapacityOneStillOrdersEverything") = []
+{
+    // One slot: every transfer happens at the full/empty boundary, so every push and
+    // pop has to refresh its cached index.
+    check(transfersInOrder<1>(200'000));
+};
+} // namespace
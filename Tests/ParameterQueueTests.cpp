@@ -0,0 +1,102 @@
+// Tests for MakeASound::ParameterQueue - typed parameter changes posted from any
+// thread and applied on the audio thread at the start of a block. What the cases
+// pin is what separate atomics can't give: changes arrive whole and in the order
+// they were posted.
+
+#include <MakeASound/Realtime/ParameterQueue.h>
+
+#include <NanoTest/NanoTest.h>
+
+#include <type_traits>
+#include <vector>
+
+using namespace nano;
+
+namespace
+{
+struct SetGain
+{
+    float gain = 0.0f;
+};
+
+struct NoteOn
+{
+    int note = 0;
+    float velocity = 0.0f;
+};
+
+struct AllNotesOff
+{
+};
+
+using Changes = MakeASound::ParameterQueue<8, SetGain, NoteOn, AllNotesOff>;
+
+// The audio thread's view of the parameters, and a log of what it applied.
+struct State
+{
+    float gain = 0.0f;
+    int note = -1;
+    float velocity = 0.0f;
+    std::vector<int> order;
+
+    int apply(Changes& changes)
+    {
+        return changes.applyPending(
+            [this](const auto& change)
+            {
+                using Change = std::decay_t<decltype(change)>;
+
+                if constexpr (std::is_same_v<Change, SetGain>)
+                {
+                    gain = change.gain;
+                    order.push_back(0);
+                }
+                else if constexpr (std::is_same_v<Change, NoteOn>)
+                {
+                    note = change.note;
+                    velocity = change.velocity;
+                    order.push_back(1);
+                }
+                else
+                {
+                    note = -1;
+                    velocity = 0.0f;
+                    order.push_back(2);
+                }
+            });
+    }
+};
+
+auto tInOrder = test("ParameterQueue/appliesChangesInPostingOrder") = []
+{
+    auto changes = Changes {};
+    auto state = State {};
+
+    check(changes.post(NoteOn {60, 0.5f}));
+    check(changes.post(SetGain {0.25f}));
+    check(changes.post(AllNotesOff {}));
+    check(changes.post(NoteOn {64, 0.75f}));
+
+    check(state.apply(changes) == 4);
+    check((state.order == std::vector<int> {1, 0, 2, 1}));
+
+    // The last note on wins, with its own velocity: the two fields travel together.
+    check(state.note == 64 && state.velocity == 0.75f);
+    check(state.gain == 0.25f);
+
+    check(state.apply(changes) == 0);
+};
+
+auto tFull = test("ParameterQueue/dropsChangesOnceFull") = []
+{
+    auto changes = Changes {};
+    auto state = State {};
+
+    for (auto i = 0; i < 8; ++i)
+        check(changes.post(SetGain {static_cast<float>(i)}));
+
+    check(!changes.post(SetGain {99.0f}));
+    check(state.apply(changes) == 8);
+    check(state.gain == 7.0f);
+};
+} // namespace
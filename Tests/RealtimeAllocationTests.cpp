@@ -0,0 +1,343 @@
+// Tests that the audio callback never allocates. This binary replaces every form of
+// the global operator new - plain, array, aligned and nothrow - and counts each
+// allocation made while a RealtimeScope is active on the calling thread, which the
+// backend opens around each block. Any heap use between miniaudio handing us a
+// period and it getting it back fails the run. Streams go through miniaudio's null
+// backend, a timer thread standing in for a device, so the path is the real one and
+// still runs on a headless CI runner.
+
+#include <MakeASound/MakeASound.h>
+
+#include <NanoTest/NanoTest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <thread>
+
+namespace
+{
+std::atomic<int> realtimeAllocations {0};
+
+// Null when out of memory; the throwing forms turn that into bad_alloc.
+void* tryAllocate(std::size_t size, std::size_t alignment = 0) noexcept
+{
+    if (MakeASound::RealtimeScope::isActive())
+        ++realtimeAllocations;
+
+    if (size == 0)
+        size = 1;
+
+    if (alignment == 0)
+        return std::malloc(size);
+
+#ifdef _WIN32
+    return _aligned_malloc(size, alignment);
+#else
+    // aligned_alloc wants the size in whole multiples of the alignment.
+    auto rounded = (size + alignment - 1) / alignment * alignment;
+    return std::aligned_alloc(alignment, rounded);
+#endif
+}
+
+void* allocate(std::size_t size, std::size_t alignment = 0)
+{
+    if (auto* ptr = tryAllocate(size, alignment))
+        return ptr;
+
+    throw std::bad_alloc {};
+}
+
+void freeAligned(void* ptr) noexcept
+{
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    std::free(ptr);
+#endif
+}
+
+std::size_t toSize(std::align_val_t alignment)
+{
+    return static_cast<std::size_t>(alignment);
+}
+} // namespace
+
+void* operator new(std::size_t size)
+{
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size)
+{
+    return allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    return allocate(size, toSize(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return allocate(size, toSize(alignment));
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return tryAllocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return tryAllocate(size);
+}
+
+void* operator new(std::size_t size,
+                   std::align_val_t alignment,
+                   const std::nothrow_t&) noexcept
+{
+    return tryAllocate(size, toSize(alignment));
+}
+
+void* operator new[](std::size_t size,
+                     std::align_val_t alignment,
+                     const std::nothrow_t&) noexcept
+{
+    return tryAllocate(size, toSize(alignment));
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+    freeAligned(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept
+{
+    freeAligned(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept
+{
+    freeAligned(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept
+{
+    freeAligned(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    freeAligned(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    freeAligned(ptr);
+}
+
+using namespace nano;
+using MakeASound::AudioCallbackInfo;
+using MakeASound::DeviceManager;
+using MakeASound::Error;
+using MakeASound::StreamConfig;
+
+namespace
+{
+// No test run leaves a backend cache in the home directory of whoever ran it.
+const auto noBackendCache = []
+{
+    DeviceManager::setCacheDirectory("");
+    return true;
+}();
+
+// The null backend's own devices, by the ids it enumerated them under, but described
+// here: it reports no channel counts of its own. Four native outputs with a stereo
+// slice out of the middle, which exercises the clearing and the offset interleave,
+// and a stereo input.
+StreamConfig makeNullConfig(DeviceManager& manager,
+                            bool nonInterleaved,
+                            bool fixedBlockSize)
+{
+    auto output = manager.getDefaultOutputDevice();
+    output.outputChannels = 4;
+
+    auto input = manager.getDefaultInputDevice();
+    input.inputChannels = 2;
+
+    auto config = StreamConfig {};
+    config.output = MakeASound::StreamParameters(output, false, 2, 1);
+    config.input = MakeASound::StreamParameters(input, true, 2);
+    config.sampleRate = 48000;
+    config.maxBlockSize = 256;
+    config.options = MakeASound::StreamOptions {};
+    config.options->flags.nonInterleaved = nonInterleaved;
+    config.options->flags.fixedBlockSize = fixedBlockSize;
+
+    return config;
+}
+
+// Runs a null-backend stream until it has seen enough blocks, and reports whether
+// they all stayed within maxBlockSize - or matched it exactly, for a fixed-size
+// stream - and nothing allocated in them. A stream that won't start fails: the only
+// build that passes without running one is one with MA_NO_NULL, which has no null
+// backend to run it on.
+bool runsWithoutAllocating(bool nonInterleaved, bool fixedBlockSize = false)
+{
+#ifdef MA_NO_NULL
+    return true;
+#endif
+
+    // Before the manager, which may still call back until it is gone.
+    auto blocks = std::atomic<int> {0};
+    auto misfit = std::atomic<int> {0};
+
+    auto manager = DeviceManager {};
+
+    if (manager.setBackend(MakeASound::Backend::Null) != Error::NoError)
+        return false;
+
+    // Allocation-free itself, so every allocation counted is the library's.
+    auto process = [&](AudioCallbackInfo& info)
+    {
+        if (info.numSamples > info.maxBlockSize
+            || (fixedBlockSize && info.numSamples != info.maxBlockSize))
+            ++misfit;
+
+        for (auto channel: info.getOutput().channels())
+            for (auto& sample: channel)
+                sample = 0.0f;
+
+        auto interleaved = info.getInterleavedOutput();
+
+        for (auto channel = 0; channel < interleaved.getNumChannels(); ++channel)
+            for (auto& sample: interleaved.getChannel(channel))
+                sample = 0.0f;
+
+        ++blocks;
+    };
+
+    realtimeAllocations = 0;
+
+    auto config = makeNullConfig(manager, nonInterleaved, fixedBlockSize);
+
+    if (manager.start(config, process) != Error::NoError)
+        return false;
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+
+    while (blocks < 16 && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+    manager.stop();
+
+    return blocks >= 16 && misfit == 0 && realtimeAllocations == 0;
+}
+
+auto tHook = test("RealtimeAllocation/countsOnlyAllocationsInsideTheScope") = []
+{
+    // The hook itself: allocations outside a scope are not the audio thread's, and
+    // the scope nests. The pointer escapes through a volatile so the new/delete pair
+    // can't be elided.
+    static void* volatile escape = nullptr;
+
+    realtimeAllocations = 0;
+    escape = new int(1);
+    delete static_cast<int*>(escape);
+    check(realtimeAllocations == 0);
+
+    {
+        auto outer = MakeASound::RealtimeScope {};
+
+        {
+            auto inner = MakeASound::RealtimeScope {};
+        }
+
+        check(MakeASound::RealtimeScope::isActive());
+
+        escape = new int(2);
+        delete static_cast<int*>(escape);
+    }
+
+    check(realtimeAllocations == 1);
+    check(!MakeASound::RealtimeScope::isActive());
+};
+
+auto tOtherForms = test("RealtimeAllocation/countsAlignedAndNothrowAllocations") = []
+{
+    // An over-aligned type goes through the align_val_t overloads and a
+    // new(std::nothrow) through the nothrow ones; neither may slip past the count.
+    struct alignas(64) Wide
+    {
+        float samples[16];
+    };
+
+    static void* volatile escape = nullptr;
+
+    realtimeAllocations = 0;
+
+    {
+        auto scope = MakeASound::RealtimeScope {};
+
+        escape = new Wide {};
+        delete static_cast<Wide*>(escape);
+
+        escape = new (std::nothrow) int(3);
+        delete static_cast<int*>(escape);
+
+        escape = new (std::nothrow) Wide {};
+        delete static_cast<Wide*>(escape);
+    }
+
+    check(realtimeAllocations == 3);
+};
+
+auto tPlanar = test("RealtimeAllocation/planarCallbackNeverAllocates") = []
+{
+    check(runsWithoutAllocating(true));
+};
+
+auto tInterleaved = test("RealtimeAllocation/interleavedCallbackNeverAllocates") = []
+{
+    check(runsWithoutAllocating(false));
+};
+
+auto tFixedBlock = test("RealtimeAllocation/fixedBlockCallbackNeverAllocates") = []
+{
+    check(runsWithoutAllocating(true, true));
+    check(runsWithoutAllocating(false, true));
+};
+} // namespace
@@ -1,14 +1,17 @@
 // Tests for MakeASound::SPSCQueue - the bounded, wait-free single-producer /
 // single-consumer queue. The single-threaded cases pin the FIFO / full / empty /
-// wrap-around semantics; the concurrent cases are the point of the exercise:
-// they run a real producer thread against a real consumer thread and prove that
-// every element crosses intact, exactly once, and in order.
+// wrap-around semantics, one element at a time and in bulk; the concurrent cases
+// are the point of the exercise: they run a real producer thread against a real
+// consumer thread and prove that every element crosses intact, exactly once, and
+// in order, whichever of the transfer calls moves it.
 
 #include <MakeASound/Realtime/SPSCQueue.h>
 
 #include <NanoTest/NanoTest.h>
 
+#include <algorithm>
 #include <atomic>
+#include <span>
 #include <thread>
 
 using namespace nano;
@@ -116,6 +119,90 @@ auto tWrapAround = test("SPSCQueue/wrapsAroundTheRingWithoutLosingOrder") = []
     check(next > 4); // sanity: we really did wrap past the buffer
 };
 
+// ---------------------------------------------------------------------------
+// Bulk and in-place transfers
+// ---------------------------------------------------------------------------
+
+auto tBulkPartial = test("SPSCQueue/pushBulkTakesWhatFitsAndPopBulkWhatIsThere") = []
+{
+    auto queue = SPSCQueue<int, 5> {};
+
+    const int items[] = {1, 2, 3, 4, 5, 6, 7};
+    check(queue.pushBulk(items) == 5); // the two that don't fit stay the caller's
+    check(queue.pushBulk(items) == 0);
+    check(queue.sizeApprox() == 5);
+
+    int out[3] = {};
+    check(queue.popBulk(out) == 3);
+    check(out[0] == 1 && out[1] == 2 && out[2] == 3);
+
+    int rest[8] = {};
+    check(queue.popBulk(rest) == 2);
+    check(rest[0] == 4 && rest[1] == 5);
+    check(queue.popBulk(rest) == 0);
+    check(queue.sizeApprox() == 0);
+};
+
+auto tRegionsWrap = test("SPSCQueue/regionsSplitWhereTheRingWraps") = []
+{
+    // Walk the cursors to the middle, so both views have to wrap.
+    auto queue = SPSCQueue<int, 6> {};
+
+    const int lead[] = {0, 0, 0, 0};
+    int sink[4] = {};
+    queue.pushBulk(lead);
+    queue.popBulk(sink);
+
+    auto write = queue.writeAvailable();
+    check(write.size() == 6);
+    check(!write.second.empty());
+
+    auto value = 100;
+    for (auto& slot: write.first)
+        slot = value++;
+    for (auto& slot: write.second)
+        slot = value++;
+
+    // Nothing is visible until it is committed, and then only what was.
+    check(queue.readAvailable().empty());
+    queue.commitWrite(5);
+    check(queue.sizeApprox() == 5);
+
+    auto read = queue.readAvailable();
+    check(read.size() == 5);
+    check(!read.second.empty());
+
+    auto expect = 100;
+    auto inOrder = true;
+    for (auto slot: read.first)
+        inOrder = inOrder && slot == expect++;
+    for (auto slot: read.second)
+        inOrder = inOrder && slot == expect++;
+    check(inOrder);
+
+    queue.commitRead(2);
+    check(queue.sizeApprox() == 3);
+
+    auto next = 0;
+    check(queue.pop(next) && next == 102);
+};
+
+auto tMixed = test("SPSCQueue/singleAndBulkCallsInterleave") = []
+{
+    auto queue = SPSCQueue<int, 4> {};
+
+    check(queue.push(1));
+    const int more[] = {2, 3};
+    check(queue.pushBulk(more) == 2);
+
+    auto value = 0;
+    check(queue.pop(value) && value == 1);
+
+    int out[4] = {};
+    check(queue.popBulk(out) == 2);
+    check(out[0] == 2 && out[1] == 3);
+};
+
 // ---------------------------------------------------------------------------
 // Concurrent producer / consumer
 // ---------------------------------------------------------------------------
@@ -213,4 +300,153 @@ auto tConcurrentTiny = test("SPSCQueue/concurrentWithCapacityOneStillOrdersEvery
     check(ok.load(std::memory_order_relaxed));
     check(receivedCount.load(std::memory_order_relaxed) == total);
 };
+
+// Bulk at both ends, with run lengths that keep changing - shorter than, equal to
+// and longer than the space there is - so partial transfers and wrapped regions both
+// happen constantly while the other thread is mid-transfer.
+auto tConcurrentBulk =
+    test("SPSCQueue/concurrentBulkTransfersDeliverEverythingInOrder") = []
+{
+    constexpr auto total = 1'000'000;
+    auto queue = SPSCQueue<Payload, 257> {};
+
+    std::atomic<bool> ok {true};
+    std::atomic<int> receivedCount {0};
+
+    auto consumer = std::thread(
+        [&]
+        {
+            auto expected = 0;
+            Payload out[300];
+            auto chunk = std::size_t {1};
+
+            while (expected < total)
+            {
+                auto count = queue.popBulk(std::span(out, chunk));
+
+                // Nothing there: let the producer run rather than spin out the
+                // rest of this thread's time slice.
+                if (count == 0)
+                    std::this_thread::yield();
+
+                for (auto i = std::size_t {0}; i < count; ++i)
+                {
+                    if (out[i].seq != expected || out[i].tag != derive(out[i].seq))
+                        ok.store(false, std::memory_order_relaxed);
+
+                    ++expected;
+                }
+
+                chunk = (chunk + 7) % 300 + 1;
+            }
+
+            receivedCount.store(expected, std::memory_order_relaxed);
+        });
+
+    Payload items[300];
+    auto next = 0;
+    auto chunk = std::size_t {1};
+
+    while (next < total)
+    {
+        auto count = std::min<std::size_t>(chunk, total - next);
+
+        for (auto i = std::size_t {0}; i < count; ++i)
+            items[i] = Payload {next + static_cast<int>(i),
+                                derive(next + static_cast<int>(i))};
+
+        auto pushed = queue.pushBulk(std::span(items, count));
+
+        if (pushed == 0)
+            std::this_thread::yield();
+
+        next += static_cast<int>(pushed);
+        chunk = (chunk + 11) % 300 + 1;
+    }
+
+    consumer.join();
+
+    check(ok.load(std::memory_order_relaxed));
+    check(receivedCount.load(std::memory_order_relaxed) == total);
+};
+
+// The zero-copy path: the producer writes straight into the ring and the consumer
+// reads straight out of it, committing only part of what it is offered, so the
+// uncommitted tail must still be there, unchanged, the next time round.
+auto tConcurrentRegions =
+    test("SPSCQueue/concurrentInPlaceRegionsDeliverEverythingInOrder") = []
+{
+    constexpr auto total = 1'000'000;
+    auto queue = SPSCQueue<Payload, 100> {};
+
+    std::atomic<bool> ok {true};
+    std::atomic<int> receivedCount {0};
+    std::atomic<bool> sizeInRange {true};
+
+    auto consumer = std::thread(
+        [&]
+        {
+            auto expected = 0;
+
+            while (expected < total)
+            {
+                if (queue.sizeApprox() > queue.capacity())
+                    sizeInRange.store(false, std::memory_order_relaxed);
+
+                auto region = queue.readAvailable();
+                auto take = (region.size() + 1) / 2;
+                auto taken = std::size_t {0};
+
+                for (auto run: {region.first, region.second})
+                {
+                    for (const auto& item: run)
+                    {
+                        if (taken == take)
+                            break;
+
+                        if (item.seq != expected || item.tag != derive(item.seq))
+                            ok.store(false, std::memory_order_relaxed);
+
+                        ++expected;
+                        ++taken;
+                    }
+                }
+
+                queue.commitRead(taken);
+
+                if (taken == 0)
+                    std::this_thread::yield();
+            }
+
+            receivedCount.store(expected, std::memory_order_relaxed);
+        });
+
+    auto next = 0;
+
+    while (next < total)
+    {
+        auto region = queue.writeAvailable();
+        auto written = std::size_t {0};
+
+        for (auto run: {region.first, region.second})
+            for (auto& slot: run)
+                if (next + static_cast<int>(written) < total)
+                {
+                    auto seq = next + static_cast<int>(written++);
+                    slot = Payload {seq, derive(seq)};
+                }
+
+        queue.commitWrite(written);
+        next += static_cast<int>(written);
+
+        if (written == 0)
+            std::this_thread::yield();
+    }
+
+    consumer.join();
+
+    check(ok.load(std::memory_order_relaxed));
+    check(sizeInRange.load(std::memory_order_relaxed));
+    check(receivedCount.load(std::memory_order_relaxed) == total);
+};
 } // namespace
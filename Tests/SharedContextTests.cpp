@@ -0,0 +1,98 @@
+// Tests for SharedContext - the one ma_context and device list that every
+// DeviceManager on a backend shares. They hold contexts directly rather than through
+// managers and pin the registry's bookkeeping: one context per backend for as long
+// as anyone holds it, a fresh one once the last holder lets go, and never a shared
+// one that failed to come up. A refresh that finds the same devices keeps the list
+// and its version. The null backend stands in where a context has to come up, which
+// every build has unless MA_NO_NULL takes it out.
+
+#include <MakeASound/MiniAudio/MiniAudioContext.h>
+
+#include <NanoTest/NanoTest.h>
+
+#include <memory>
+
+using namespace nano;
+using MakeASound::Backend;
+using MakeASound::Error;
+using MakeASound::MiniAudio::SharedContext;
+
+namespace
+{
+// A backend no build for this platform compiles in, so its context can't come up.
+constexpr auto unavailableBackend =
+#if defined(_WIN32)
+    Backend::CoreAudio;
+#else
+    Backend::WASAPI;
+#endif
+
+auto tShared = test("SharedContext/oneContextPerBackendWhileItIsHeld") = []
+{
+#ifdef MA_NO_NULL
+    return;
+#endif
+
+    auto first = SharedContext::acquire(Backend::Null);
+    auto second = SharedContext::acquire(Backend::Null);
+
+    check(first != nullptr && first->isInitialised());
+    check(first == second);
+
+    // The device list with it: both see the very same snapshot.
+    check(first->load() == second->load());
+};
+
+auto tFresh = test("SharedContext/freshContextOnceEveryHolderLetsGo") = []
+{
+#ifdef MA_NO_NULL
+    return;
+#endif
+
+    auto held = SharedContext::acquire(Backend::Null);
+    auto version = held->load()->version;
+    auto watcher = std::weak_ptr<SharedContext> {held};
+
+    held.reset();
+
+    // The registry holds it weakly: nothing else kept it alive.
+    check(watcher.expired());
+
+    auto next = SharedContext::acquire(Backend::Null);
+
+    check(next->isInitialised());
+    check(next->load()->version > version);
+};
+
+auto tUnchanged = test("SharedContext/sameListKeepsItsVersionAndSnapshot") = []
+{
+#ifdef MA_NO_NULL
+    return;
+#endif
+
+    // The null backend's list never changes, so looking again finds nothing new: a
+    // host polling the version has no menu to rebuild.
+    auto context = SharedContext::acquire(Backend::Null);
+    auto before = context->load();
+    auto version = context->getVersion();
+
+    check(context->refresh() == Error::NoError);
+    check(context->getVersion() == version);
+    check(context->load() == before);
+};
+
+auto tFailed = test("SharedContext/failedContextIsNotShared") = []
+{
+    auto first = SharedContext::acquire(unavailableBackend);
+    auto second = SharedContext::acquire(unavailableBackend);
+
+    check(!first->isInitialised());
+    check(first->getInitError() != Error::NoError);
+
+    // Each caller gets one of its own, so the next to ask tries the backend again.
+    check(first != second);
+
+    // With nothing to enumerate, an empty list rather than none.
+    check(first->load() != nullptr && first->load()->devices.empty());
+};
+} // namespace
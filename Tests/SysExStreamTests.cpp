@@ -0,0 +1,211 @@
+// Tests for MakeASound::SysExStream - the byte arena long SysEx is reassembled in.
+// The single-threaded cases pin the framing: every byte of every message comes out
+// intact and in order however the stream was chunked, including across the arena's
+// wrap, and a message that can't fit is dropped whole and counted rather than
+// delivered cut short. The concurrent case feeds and drains megabytes on two
+// threads and checks none of it is lost.
+
+#include <MakeASound/MIDI/SysExStream.h>
+
+#include <NanoTest/NanoTest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using namespace nano;
+using MakeASound::SysExStream;
+
+namespace
+{
+using Bytes = std::vector<std::uint8_t>;
+
+// F0, a manufacturer id, `payload` bytes counting up from `seed`, F7.
+Bytes makeSysEx(std::size_t payload, int seed)
+{
+    auto bytes = Bytes {0xF0, 0x7D};
+
+    for (auto i = std::size_t {0}; i < payload; ++i)
+        bytes.push_back(
+            static_cast<std::uint8_t>((seed + static_cast<int>(i)) & 0x7F));
+
+    bytes.push_back(0xF7);
+    return bytes;
+}
+
+std::vector<Bytes> drainAll(SysExStream& stream)
+{
+    auto out = std::vector<Bytes> {};
+    stream.drain([&](std::span<const std::uint8_t> message)
+                 { out.emplace_back(message.begin(), message.end()); });
+    return out;
+}
+
+auto tWhole = test("SysExStream/wholeMessageComesOutIntact") = []
+{
+    auto stream = SysExStream {1024};
+    auto message = makeSysEx(300, 1);
+
+    stream.feed(message);
+
+    auto out = drainAll(stream);
+    check(out.size() == 1);
+    check(!out.empty() && out[0] == message);
+};
+
+auto tChunks = test("SysExStream/reassemblesAnyChunking") = []
+{
+    auto stream = SysExStream {4096};
+    auto first = makeSysEx(500, 3);
+    auto second = makeSysEx(20, 9);
+
+    auto joined = first;
+    joined.insert(joined.end(), second.begin(), second.end());
+
+    // Chunks of 7: boundaries fall everywhere, one straddles both messages.
+    for (auto i = std::size_t {0}; i < joined.size(); i += 7)
+    {
+        auto end = std::min(joined.size(), i + 7);
+        stream.feed({joined.data() + i, end - i});
+    }
+
+    auto out = drainAll(stream);
+    check(out.size() == 2);
+    check(out.size() == 2 && out[0] == first && out[1] == second);
+};
+
+auto tRealtime = test("SysExStream/skipsRealtimeBytesInside") = []
+{
+    auto stream = SysExStream {64};
+    auto fed = Bytes {0xF0, 0x01, 0xF8, 0x02, 0xFE, 0xF7};
+
+    stream.feed(fed);
+
+    auto out = drainAll(stream);
+    check(out.size() == 1);
+    check(!out.empty() && out[0] == Bytes {0xF0, 0x01, 0x02, 0xF7});
+};
+
+auto tAbandon = test("SysExStream/statusByteAbandonsMessage") = []
+{
+    auto stream = SysExStream {64};
+    auto fed = Bytes {0xF0, 0x01, 0x02, 0x90, 0x40, 0x7F, 0xF0, 0x03, 0xF7};
+
+    stream.feed(fed);
+
+    auto out = drainAll(stream);
+    check(out.size() == 1);
+    check(!out.empty() && out[0] == Bytes {0xF0, 0x03, 0xF7});
+    check(stream.getDropped() == 1);
+};
+
+auto tTooLong = test("SysExStream/longerThanArenaIsDropped") = []
+{
+    auto stream = SysExStream {100};
+
+    stream.feed(makeSysEx(200, 0));
+    stream.feed(makeSysEx(10, 0));
+
+    auto out = drainAll(stream);
+    check(out.size() == 1);
+    check(!out.empty() && out[0].size() == 13);
+    check(stream.getDropped() == 1);
+};
+
+auto tFull = test("SysExStream/fullArenaDropsUntilDrained") = []
+{
+    auto stream = SysExStream {100};
+
+    stream.feed(makeSysEx(60, 0));
+    stream.feed(makeSysEx(60, 0));
+
+    check(stream.getDropped() == 1);
+    check(drainAll(stream).size() == 1);
+
+    stream.feed(makeSysEx(60, 5));
+    auto out = drainAll(stream);
+    check(out.size() == 1);
+    check(!out.empty() && out[0] == makeSysEx(60, 5));
+};
+
+// Message sizes that don't divide the arena, so they keep landing across its end
+// and have to move to the start.
+auto tWrap = test("SysExStream/messagesSurviveTheWrap") = []
+{
+    auto stream = SysExStream {256};
+
+    for (auto i = 0; i < 200; ++i)
+    {
+        auto message = makeSysEx(static_cast<std::size_t>(37 + i % 50), i);
+        stream.feed(message);
+
+        auto out = drainAll(stream);
+        check(out.size() == 1);
+        check(!out.empty() && out[0] == message);
+    }
+
+    check(stream.getDropped() == 0);
+};
+
+// A 4 MB sample dump in 4 KB messages, fed in 256-byte chunks as a driver would
+// deliver them, drained on another thread through a 64 KB arena. The feeder waits
+// whenever the arena is full, as a sender pacing a dump would; nothing is lost.
+auto tThroughput = test("SysExStream/megabytesAcrossThreads") = []
+{
+    constexpr auto messageCount = 1024;
+    constexpr auto payload = std::size_t {4096};
+
+    auto stream = SysExStream {64 * 1024};
+    auto delivered = std::atomic<int> {0};
+    auto corrupt = std::atomic<int> {0};
+
+    auto drainer = std::thread(
+        [&]
+        {
+            auto next = 0;
+
+            while (next < messageCount)
+            {
+                stream.drain(
+                    [&](std::span<const std::uint8_t> message)
+                    {
+                        auto expected = makeSysEx(payload, next);
+
+                        if (!std::equal(message.begin(),
+                                        message.end(),
+                                        expected.begin(),
+                                        expected.end()))
+                            corrupt.fetch_add(1);
+
+                        ++next;
+                        delivered.store(next);
+                    });
+
+                std::this_thread::yield();
+            }
+        });
+
+    for (auto i = 0; i < messageCount; ++i)
+    {
+        // Room for this one: at most a dozen in the arena at a time.
+        while (i - delivered.load() >= 12)
+            std::this_thread::yield();
+
+        auto message = makeSysEx(payload, i);
+
+        for (auto at = std::size_t {0}; at < message.size(); at += 256)
+        {
+            auto end = std::min(message.size(), at + 256);
+            stream.feed({message.data() + at, end - at});
+        }
+    }
+
+    drainer.join();
+
+    check(delivered.load() == messageCount);
+    check(corrupt.load() == 0);
+    check(stream.getDropped() == 0);
+};
+} // namespace